@@ -8,6 +8,8 @@
 #include <regex>
 #include <algorithm>
 
+#include <Components/SystemProcessing/FsRoot.h>
+
 namespace Libraries
 {
 
@@ -80,7 +82,7 @@ SysinfoMaster ConstantMaster::getDmiManager() const
 
 void ConstantMaster::updateCardPciEqus()
 {
-    const std::string drmDirPath   = "/sys/class/drm";      // Directory to search in
+    const std::string drmDirPath   = SystemProcessing::FsRoot::path("/sys/class/drm");  // Directory to search in
 
     // Get count of directory subdirs (cards actually)
     int16_t cardCount = FileworkUtil::dirsCount(drmDirPath);
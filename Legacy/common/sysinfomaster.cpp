@@ -20,6 +20,8 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <Components/SystemProcessing/TraceRecorder.h>
+
 
 
 
@@ -81,15 +83,29 @@ hwNode *SysinfoMaster::getPropertyTree()
     return &d->computer;
 }
 
+namespace
+{
+
+template <typename ScanFunction>
+bool tracedScan(const char* traceName, ScanFunction scan, hwNode& node)
+{
+    SYSTEMPROCESSING_TRACE(trace, traceName);
+    return scan(node);
+}
+
+} // namespace
+
 void SysinfoMaster::scanDevices()
 {
-    scan_dmi(d->computer);
-    scan_network(d->computer);
-    scan_nvme(d->computer);
-    if(!scan_pci(d->computer))
+    SYSTEMPROCESSING_TRACE(trace, "sysinfo.scan");
+
+    tracedScan("sysinfo.scan.dmi", scan_dmi, d->computer);
+    tracedScan("sysinfo.scan.network", scan_network, d->computer);
+    tracedScan("sysinfo.scan.nvme", scan_nvme, d->computer);
+    if(!tracedScan("sysinfo.scan.pci", scan_pci, d->computer))
     {
         COMPLOG_WARNING("Error scanning PCI, trying legacy scan");
-        scan_pci_legacy(d->computer);
+        tracedScan("sysinfo.scan.pciLegacy", scan_pci_legacy, d->computer);
     }
 //     It gather bad data, maybe next time
 //    scan_cpuinfo(d->computer);
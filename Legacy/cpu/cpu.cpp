@@ -1,5 +1,10 @@
 #include "cpu.hpp"
 
+#include <Components/SystemProcessing/CpufreqReader.h>
+#include <Components/SystemProcessing/HwmonRegistry.h>
+
+#include <mutex>
+
 
 namespace Hardware
 {
@@ -18,103 +23,33 @@ std::string Hardware::CPU::uuid() const
 
 int64_t CPU::currentTemperature() const noexcept
 {
-    const std::string tempDataFile = "/sys/class/hwmon/hwmon2/temp1_input";
+    // Scanned once, sensor files stay opened for the process lifetime
+    static const SystemProcessing::HwmonRegistry hwmonRegistry;
+    static const auto pTemperatureSensor = hwmonRegistry.findCPUTemperature();
 
-    std::string temperatureString;
-    if (!Libraries::FileworkUtil::readFileData(tempDataFile, temperatureString))
+    double temperature {};
+    if (pTemperatureSensor == nullptr || !hwmonRegistry.read(*pTemperatureSensor, temperature))
     {
         COMPLOG_WARNING("Error getting CPU temperature");
         return 0;
     }
-
-    // Data in a file represented like 46 123 what mean 46,123 C degrees
-    return Libraries::safeSton<int64_t>(temperatureString).tryGetValue() / 1000;
-}
-
-double CPU::powerUsage() const noexcept
-{
-    double result = 0.0;
-
-    // - "timeout 1.1 turbostat --Summary --quiet --show PkgWatt --interval 1 |
-    // gawk 'NR>1 and $1>0 { print substr($1, 1, 4); fflush(); }'" std::string
-    // output; if (ProcessWorking::ProcessInvoker::invoke("turbostat",
-    // "--Summary
-    // --quiet --show PkgWatt --interval 1 | grep -o -E
-    // '\\b[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?\\b'", output, 1500))
-    // {
-    //     COMPLOG_WARNING("Error getting CPU power usage with text: %s",
-    //     output.c_str());
-    // }
-
-    // try {
-    //     result = std::stod(output);
-    // } catch (const std::invalid_argument &exc) {
-    //     // TODO: Handle error
-    // }
-
-    return result;
+    return temperature;
 }
 
 double Hardware::CPU::currentClock() const
 {
-    double result = 0.0;
-
-    std::string output;
-
-    Libraries::StringList paramList;
-    paramList << "-F:"
-              << "'/cpu MHz/ {sum+=$2; count++} END {print sum/count}'"
-              << "/proc/cpuinfo";
+    // Cores are opened once; the scheduler thread and requests may sample concurrently
+    static SystemProcessing::CpufreqReader cpufreqReader;
+    static SystemProcessing::CPUFrequencies frequencies;
+    static std::mutex cpufreqMx;
 
-    if (!Libraries::ProcessInvoker::invoke("awk", paramList, output, 1000))
+    std::lock_guard lock(cpufreqMx);
+    if (!cpufreqReader.read(frequencies))
     {
-        COMPLOG_WARNING("Error getting CPU clock current with text:",
-                    output.c_str());
-        return result;
-    }
-
-    try
-    {
-        result = Libraries::safeSton<double>(output);
-    } catch (const std::invalid_argument& exc)
-    {
-        // Do nothing, result will be zero on error
-    }
-
-    return result;
-}
-
-int64_t Hardware::CPU::getCurrentClock() const
-{
-    std::string catProcInfoRes;
-
-    Libraries::ProcessInvoker::invoke(
-                "cat",
-                "/proc/cpuinfo | grep '^cpu MHz.*$' | grep -o "
-                "'[0-9]\\{0,4\\}\\.[0-9]\\{0,4\\}'",
-                catProcInfoRes);
-    if (!catProcInfoRes.size()) return 0;
-
-    double averageFreq = 0; // TODO: Do rightly
-    int cpuCoreCount   = 0;
-
-    std::string currentFreqLine;
-    std::string::iterator posBegin = catProcInfoRes.begin(),
-            posEnd   = std::find(catProcInfoRes.begin(),
-                                 catProcInfoRes.end(), '\n');
-    while (posBegin < catProcInfoRes.end())
-    {
-        averageFreq +=
-                Libraries::safeSton<double>(std::string(posBegin, posEnd)).tryGetValue();
-        cpuCoreCount++;
-
-        posBegin = posEnd + 1,
-                posEnd   = std::find(posBegin, catProcInfoRes.end(), '\n');
+        COMPLOG_WARNING("Error getting CPU clock current");
+        return 0;
     }
-
-    if (cpuCoreCount == 0) return 0;
-
-    return averageFreq / double(cpuCoreCount);
+    return frequencies.avgMHz;
 }
 
 void Hardware::CPU::setHugepagesCount(int64_t newCount)
@@ -152,9 +87,31 @@ void Hardware::CPU::init()
 
 void Hardware::CPU::updateDynamic()
 {
-    info.temperature.current = currentTemperature();
-    info.power.current       = powerUsage();
-    info.clock.current       = currentClock();
+    // Power is set by CPU_Manager, which reads the RAPL counters of all packages at once
+    for (auto metric : {DynamicMetric::Temperature, DynamicMetric::Clock}) {
+        setDynamic(metric, sampleDynamic(metric));
+    }
+}
+
+double Hardware::CPU::sampleDynamic(DynamicMetric metric) const
+{
+    switch (metric)
+    {
+    case DynamicMetric::Temperature: return currentTemperature();
+    case DynamicMetric::Power: return info.power.current;
+    case DynamicMetric::Clock: return currentClock();
+    }
+    return 0;
+}
+
+void Hardware::CPU::setDynamic(DynamicMetric metric, double value)
+{
+    switch (metric)
+    {
+    case DynamicMetric::Temperature: info.temperature.current = static_cast<int64_t>(value); break;
+    case DynamicMetric::Power: info.power.current = value; break;
+    case DynamicMetric::Clock: info.clock.current = value; break;
+    }
 }
 
 nlohmann::json Hardware::CPU::getAllInfo()
@@ -193,13 +150,13 @@ nlohmann::json Hardware::CPU::getAllInfo()
     return allJson;
 }
 
-nlohmann::json Hardware::CPU::getDynamic()
+nlohmann::json Hardware::CPU::getDynamic() const
 {
     nlohmann::json result;
     result["id"]          = info.guid;
-    result["power"]       = powerUsage();
-    result["clock"]       = currentClock();
-    result["temperature"] = currentTemperature();
+    result["power"]       = info.power.current;
+    result["clock"]       = info.clock.current;
+    result["temperature"] = info.temperature.current;
     result["fan"]         = 0;
     return result;
 }
@@ -30,15 +30,23 @@ class CPU
     void init();
     void updateDynamic();
 
+    enum class DynamicMetric {
+        Temperature,
+        Power,
+        Clock
+    };
+
+    // For the adaptive scheduler: sampling runs outside of the manager's lock, storing under it
+    double sampleDynamic(DynamicMetric metric) const;
+    void setDynamic(DynamicMetric metric, double value);
+
     nlohmann::json getAllInfo();
-    nlohmann::json getDynamic();
+    nlohmann::json getDynamic() const; // Last sampled values, doesn't read the sources
     bool setOverclock(const nlohmann::json& overclockJson);
 
   private:
     int64_t currentTemperature() const noexcept;
-    double powerUsage() const noexcept;
     double currentClock() const;
-    int64_t getCurrentClock() const;
     void setHugepagesCount(int64_t newCount);
 
     Libraries::Internal::CPU_Parameters info;
@@ -4,26 +4,120 @@
 #include <Libraries/Constants/ConstantMaster.hpp>
 #include <Libraries/Datawork/HWNodesWork.hpp>
 
+#include <Components/SystemProcessing/AdaptiveScheduler.h>
+#include <Components/SystemProcessing/RaplReader.h>
+#include <Components/SystemProcessing/TraceRecorder.h>
+
 #include <lshw-dmi/common.h>
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <set>
+
 #include "cpu.hpp"
 
 namespace Hardware
 {
 
+namespace
+{
+
+struct MetricSchedule {
+    CPU::DynamicMetric metric;
+    const char* name;
+    SystemProcessing::AdaptivePolicy policy;
+};
+
+SystemProcessing::AdaptivePolicy makePolicy(int baseMs, int minMs, int maxMs, double volatileDelta, double stableDelta)
+{
+    SystemProcessing::AdaptivePolicy policy;
+    policy.basePeriod    = std::chrono::milliseconds(baseMs);
+    policy.minPeriod     = std::chrono::milliseconds(minMs);
+    policy.maxPeriod     = std::chrono::milliseconds(maxMs);
+    policy.volatileDelta = volatileDelta;
+    policy.stableDelta   = stableDelta;
+    return policy;
+}
+
+// Temperature moves slowly but gets attention near the throttling point; clock follows the load
+const std::vector<MetricSchedule>& cpuMetricSchedules()
+{
+    static const std::vector<MetricSchedule> schedules = []() {
+        auto temperaturePolicy = makePolicy(2000, 500, 10000, 3, 1);
+        temperaturePolicy.threshold       = 85;
+        temperaturePolicy.thresholdMargin = 5;
+
+        return std::vector<MetricSchedule> {
+            {CPU::DynamicMetric::Temperature, "cpu.temperature", temperaturePolicy},
+            {CPU::DynamicMetric::Clock, "cpu.clock", makePolicy(1000, 250, 10000, 300, 50)},
+        };
+    }();
+    return schedules;
+}
+
+} // namespace
+
 struct CPU_Manager::CPUManagerPrivate {
     std::vector<CPU> cpus;
 
+    // Guards the dynamic values of cpus between the scheduler thread and requests
+    std::mutex dynamicMx;
+    std::vector<int> samplingTasks;
+
+    // One reader for all packages: each read is the delta since the previous one,
+    // so per-CPU readers or callers would split the interval between them
+    std::mutex raplMx;
+    SystemProcessing::RaplReader rapl;
+    SystemProcessing::RaplPower power;
+
+    // Sets the power of every CPU from its package, returns the total for the scheduler
+    std::optional<double> updatePower()
+    {
+        std::lock_guard raplLock(raplMx);
+        if (!rapl.isOpened() || !rapl.read(power)) {
+            return std::nullopt;
+        }
+
+        // Processor nodes come in socket order, so CPU i is package i
+        const auto& zones = rapl.zones();
+        std::lock_guard lock(dynamicMx);
+        for (size_t cpuIndex = 0; cpuIndex < cpus.size(); ++cpuIndex) {
+            double packageWatts {0};
+            for (size_t zoneIndex = 0; zoneIndex < zones.size() && zoneIndex < power.zoneWatts.size(); ++zoneIndex) {
+                if (zones[zoneIndex].domain == SystemProcessing::RaplDomain::Package
+                        && zones[zoneIndex].package == static_cast<int>(cpuIndex)) {
+                    packageWatts += power.zoneWatts[zoneIndex];
+                }
+            }
+            cpus[cpuIndex].setDynamic(CPU::DynamicMetric::Power, packageWatts);
+        }
+        return power.packageWatts;
+    }
+
+    ~CPUManagerPrivate()
+    {
+        for (auto taskId : samplingTasks) {
+            SystemProcessing::AdaptiveScheduler::getInstance().removeTask(taskId);
+        }
+    }
+
     std::vector<Libraries::Internal::CPU_Parameters> cpuParameters;
+    std::set<std::string> cpuNodeIds;
 
-    void addCpu(hwNode* pNode)
+    // Returns false for an empty socket or a node seen already. Identical processors of
+    // a dual-socket board compare equal by value, so nodes are told apart by DMI handle or physid
+    bool addCpu(hwNode* pNode)
     {
-        decltype(cpuParameters)::iterator cpuIt;
-        if (cpuParameters.empty()) {
-            cpuParameters.push_back({});
-            cpuIt = cpuParameters.end() - 1;
+        if (!pNode->enabled()) {
+            return false;
+        }
+        const auto nodeId = pNode->getHandle().empty() ? pNode->getPhysId() : pNode->getHandle();
+        if (!nodeId.empty() && !cpuNodeIds.insert(nodeId).second) {
+            return false;
         }
-        auto& cpuParams = *cpuIt;
+
+        Libraries::Internal::CPU_Parameters cpuParams;
         Libraries::setupFromNode(pNode, &cpuParams);
 
         cpuParams.vendor = std::regex_replace(cpuParams.vendor.tryGetValue(), std::regex("Advanced Micro Devices, Inc."), "AMD");
@@ -43,15 +137,15 @@ struct CPU_Manager::CPUManagerPrivate {
         cpuParams.coreCount       = Libraries::safeSton<int64_t>(pNode->getConfig("cores"));
         cpuParams.enabledCores    = Libraries::safeSton<int64_t>(pNode->getConfig("enabledcores"));
         cpuParams.threadTotal     = Libraries::safeSton<int64_t>(pNode->getConfig("threads"));
-        cpuParams.socketCount     = 1; // TODO: Get real value?
 
-        // Setup depend values
+        // Setup depend values; the socket count is known once all nodes are added
         if (cpuParams.threadTotal.has_value()) {
             if (cpuParams.coreCount.has_value() && (cpuParams.coreCount.value() != 0))
                 cpuParams.threadPerCore = (cpuParams.threadTotal.tryGetValue() / cpuParams.coreCount.tryGetValue());
-
-            if (cpuParams.socketCount.has_value() && (cpuParams.socketCount.value() != 0))
-                cpuParams.coresPerSocket = (cpuParams.threadTotal.tryGetValue() / cpuParams.socketCount.tryGetValue());
+        }
+        // A processor node is one socket, its core count is per socket
+        if (cpuParams.coreCount.has_value()) {
+            cpuParams.coresPerSocket = cpuParams.coreCount.tryGetValue();
         }
 
         // TODO: Deal with it?
@@ -59,18 +153,32 @@ struct CPU_Manager::CPUManagerPrivate {
         cpuParams.temperature.defaultVal    = 95;
 
         cpuParams.valuesCheckup();
-        if (cpuParameters.empty()) {
-            cpuParameters.push_back(cpuParams);
-            return;
-        }
-        if (cpuParams != cpuParameters.back()) {
-            cpuParameters.push_back(cpuParams);
+        cpuParameters.push_back(cpuParams);
+        return true;
+    }
+
+    static bool isCacheNode(hwNode* pNode)
+    {
+        // Memory banks have a width, BIOS is a ROM
+        return (pNode->getSize() != 0) && (pNode->getDescription() != "BIOS") && (pNode->getWidth() == 0);
+    }
+
+    static void setCacheSize(Libraries::Internal::CPU_Parameters& rCpu, hwNode* pNode, bool onlyMissing)
+    {
+        auto cacheLevel = Libraries::safeSton<int64_t>(pNode->getConfig("level"));
+        switch (cacheLevel.tryGetValue())
+        {
+        case 1: if (!onlyMissing || !rCpu.cacheSize.l1.has_value()) rCpu.cacheSize.l1 = pNode->getSize() / 1024; break;
+        case 2: if (!onlyMissing || !rCpu.cacheSize.l2.has_value()) rCpu.cacheSize.l2 = pNode->getSize() / 1024; break;
+        case 3: if (!onlyMissing || !rCpu.cacheSize.l3.has_value()) rCpu.cacheSize.l3 = pNode->getSize() / 1024; break;
         }
     }
 };
 
 void CPU_Manager::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "cpu.manager.init");
+
     d = std::make_shared<CPUManagerPrivate>();    
     parseNodeTree();
 
@@ -85,7 +193,30 @@ void CPU_Manager::init()
     setCanWork(true);
 }
 
-void CPU_Manager::start() {}
+void CPU_Manager::start()
+{
+    if (!d || !d->samplingTasks.empty()) {
+        return;
+    }
+
+    auto& scheduler = SystemProcessing::AdaptiveScheduler::getInstance();
+    auto pPrivate = d.get();
+    for (size_t cpuIndex = 0; cpuIndex < d->cpus.size(); ++cpuIndex) {
+        for (auto& schedule : cpuMetricSchedules()) {
+            const auto metric = schedule.metric;
+            d->samplingTasks.push_back(scheduler.addTask(schedule.name, schedule.policy,
+                [pPrivate, cpuIndex, metric]() -> std::optional<double> {
+                    const double value = pPrivate->cpus[cpuIndex].sampleDynamic(metric);
+                    std::lock_guard lock(pPrivate->dynamicMx);
+                    pPrivate->cpus[cpuIndex].setDynamic(metric, value);
+                    return value;
+                }));
+        }
+    }
+    d->samplingTasks.push_back(scheduler.addTask("cpu.power", makePolicy(1000, 250, 10000, 10, 1),
+        [pPrivate]() { return pPrivate->updatePower(); }));
+    scheduler.start();
+}
 
 nlohmann::json CPU_Manager::processInfoRequestPrivate(const std::string& uuid)
 {
@@ -96,8 +227,14 @@ nlohmann::json CPU_Manager::processInfoRequestPrivate(const std::string& uuid)
 nlohmann::json
 CPU_Manager::processDynamicRequestPrivate(const std::string& uuid)
 {
-    for (auto cpu : d->cpus)
-        cpu.updateDynamic();
+    // Without the scheduler the values are sampled on request, as before
+    if (d->samplingTasks.empty()) {
+        for (auto& cpu : d->cpus)
+            cpu.updateDynamic();
+        d->updatePower();
+    }
+
+    std::lock_guard lock(d->dynamicMx);
     return dynamicData();
 }
 
@@ -131,7 +268,7 @@ nlohmann::json CPU_Manager::getAllInfo()
 nlohmann::json CPU_Manager::dynamicData()
 {
     decltype(dynamicData()) result;
-    for (auto cpu : d->cpus)
+    for (auto& cpu : d->cpus)
     {
         result.push_back(cpu.getDynamic());
     }
@@ -144,27 +281,40 @@ void CPU_Manager::parseNodeTree()
     std::vector<hwNode*> processorNodes;
     Libraries::searchForDevices(hw::hwClass::processor, selfDevice, processorNodes);
 
-    std::vector<hwNode*> memoryNodes;
-    Libraries::searchForDevices(hw::hwClass::memory, selfDevice, memoryNodes);
+    // Caches not found under any processor node, some DMI tables list them at the top level
+    std::vector<hwNode*> unboundCacheNodes;
+    Libraries::searchForDevices(hw::hwClass::memory, selfDevice, unboundCacheNodes);
 
+    // lshw puts the caches of each socket under its processor node
+    std::vector<hwNode*> cacheNodes;
     for (auto pNode : processorNodes) {
-        d->addCpu(pNode);
-    }
+        cacheNodes.clear();
+        Libraries::searchForDevices(hw::hwClass::memory, pNode, cacheNodes);
+        for (auto pCache : cacheNodes) {
+            unboundCacheNodes.erase(std::remove(unboundCacheNodes.begin(), unboundCacheNodes.end(), pCache), unboundCacheNodes.end());
+        }
 
-    for (auto pNode : memoryNodes) {
-        if ((pNode->getSize() == 0) || (pNode->getDescription() == "BIOS") || ((pNode->getWidth() != 0))) {
+        if (!d->addCpu(pNode)) {
             continue;
         }
+        for (auto pCache : cacheNodes) {
+            if (CPUManagerPrivate::isCacheNode(pCache)) {
+                CPUManagerPrivate::setCacheSize(d->cpuParameters.back(), pCache, false);
+            }
+        }
+    }
 
-        auto& rCpu = d->cpuParameters.back(); // TODO: Idk how to work with more than 1 CPU
+    // Every populated processor node is a socket
+    for (auto& rCpu : d->cpuParameters) {
+        rCpu.socketCount = static_cast<int64_t>(d->cpuParameters.size());
+    }
 
-        // Get cache info
-        auto cacheLevel = Libraries::safeSton<int64_t>(pNode->getConfig("level"));
-        switch (cacheLevel.tryGetValue())
-        {
-        case 1: rCpu.cacheSize.l1 = pNode->getSize() / 1024; break;
-        case 2: rCpu.cacheSize.l2 = pNode->getSize() / 1024; break;
-        case 3: rCpu.cacheSize.l3 = pNode->getSize() / 1024; break;
+    // Sockets of one board carry the same model, so unbound caches fill the levels each CPU is missing
+    for (auto& rCpu : d->cpuParameters) {
+        for (auto pNode : unboundCacheNodes) {
+            if (CPUManagerPrivate::isCacheNode(pNode)) {
+                CPUManagerPrivate::setCacheSize(rCpu, pNode, true);
+            }
         }
     }
 }
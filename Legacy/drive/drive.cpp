@@ -10,6 +10,8 @@
 #include <Libraries/Processes/PackageManager.hpp>
 #include <Libraries/Processes/ProcessInvoker.hpp>
 
+#include <Components/SystemProcessing/ProbeStats.h>
+
 namespace Hardware
 {
 
@@ -55,6 +57,8 @@ int64_t Drive::temperature() const
     std::string harddrivePath = "/dev/" + m_info.logicalName.tryGetValue();
 
     // Returned value boost::optional<std::string>
+    SYSTEMPROCESSING_PROBE(probe, "drive.temperature.smartctl");
+    probe.addSubprocess();
     std::string output;
     if (!Libraries::ProcessInvoker::invoke(
             "smartctl",
@@ -64,6 +68,7 @@ int64_t Drive::temperature() const
                 "'{$1=$1};1' | xargs",
             output))
     {
+        probe.fail();
         COMPLOG_WARNING("Error getting temperature of hard drive: %s",
                     m_info.logicalName.tryGetValue());
     }
@@ -88,6 +93,16 @@ void Drive::updateDynamic()
     m_info.space.used          = (this->capacity() / 1024 / 1024 - m_info.space.free.tryGetValue());
 }
 
+int64_t Drive::sampleTemperature() const
+{
+    return temperature();
+}
+
+void Drive::setTemperature(int64_t temperature)
+{
+    m_info.temperature.current = temperature;
+}
+
 std::string Drive::uuid() const
 {
     return m_info.guid.tryGetValue();
@@ -106,14 +121,12 @@ nlohmann::json Drive::getAllParameters()
     return allJson;
 }
 
-nlohmann::json Drive::getDynamicParameters()
+nlohmann::json Drive::getDynamicParameters() const
 {
-    updateDynamic();
-
     nlohmann::json allInfo;
     allInfo["id"]          = m_info.guid;
     allInfo["power"] = 0; // TODO: Write correct
-    allInfo["temperature"] = temperature();
+    allInfo["temperature"] = m_info.temperature.current;
     allInfo["available"] = this->free();
     allInfo["used"] = this->capacity() - this->free();
     return allInfo;
@@ -22,10 +22,14 @@ class Drive
     void init();
     void updateDynamic();
 
+    // smartctl is the only expensive dynamic value, the adaptive scheduler refreshes it on its own
+    int64_t sampleTemperature() const;
+    void setTemperature(int64_t temperature);
+
     std::string uuid() const;
 
     nlohmann::json getAllParameters();
-    nlohmann::json getDynamicParameters();
+    nlohmann::json getDynamicParameters() const; // Last sampled values, doesn't run smartctl
 
 private:
   Libraries::Internal::DriveParameters m_info;
@@ -14,6 +14,12 @@
 #include <Libraries/Processes/ProcessInvoker.hpp>
 #include <Libraries/Datawork/HWNodesWork.hpp>
 
+#include <Components/SystemProcessing/AdaptiveScheduler.h>
+#include <Components/SystemProcessing/TraceRecorder.h>
+#include <Components/SystemProcessing/ProbeStats.h>
+
+#include <mutex>
+
 #include "drive.hpp"
 
 #if (__cplusplus > 201402L)
@@ -27,14 +33,47 @@ namespace stdfs = std::experimental::filesystem;
 namespace Hardware
 {
 
+namespace
+{
+
+// SMART temperature changes over minutes; a hot drive is polled every 10 s
+SystemProcessing::AdaptivePolicy driveTemperaturePolicy()
+{
+    SystemProcessing::AdaptivePolicy policy;
+    policy.basePeriod      = std::chrono::seconds(60);
+    policy.minPeriod       = std::chrono::seconds(10);
+    policy.maxPeriod       = std::chrono::seconds(300);
+    policy.volatileDelta   = 3;
+    policy.stableDelta     = 1;
+    policy.threshold       = 60;
+    policy.thresholdMargin = 5;
+    policy.isBlocking      = true;     // smartctl pipeline
+    return policy;
+}
+
+} // namespace
+
 struct DriveManager::DriveManagerPrivate {
     std::vector<Drive> m_drives;
     std::vector<Libraries::Internal::DriveParameters> driveParameters;
 
+    // Guards the dynamic values of m_drives between the scheduler thread and requests
+    std::mutex dynamicMx;
+    std::vector<int> samplingTasks;
+
+    ~DriveManagerPrivate()
+    {
+        for (auto taskId : samplingTasks) {
+            SystemProcessing::AdaptiveScheduler::getInstance().removeTask(taskId);
+        }
+    }
+
     std::vector<std::string> getAllDrives()
     {
         std::vector<std::string> harddrives;
 
+        SYSTEMPROCESSING_PROBE(probe, "drive.list.lsblk");
+        probe.addSubprocess();
         std::string result;
         if (!Libraries::ProcessInvoker::invoke(
                 "lsblk",
@@ -146,6 +185,8 @@ struct DriveManager::DriveManagerPrivate {
 
 void DriveManager::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "drive.manager.init");
+
     d = std::make_shared<DriveManagerPrivate>();
     parseNodeTree();
 
@@ -163,7 +204,25 @@ void DriveManager::init()
     setCanWork();
 }
 
-void DriveManager::start() {}
+void DriveManager::start()
+{
+    if (!d || !d->samplingTasks.empty()) {
+        return;
+    }
+
+    auto& scheduler = SystemProcessing::AdaptiveScheduler::getInstance();
+    auto pPrivate = d.get();
+    for (size_t driveIndex = 0; driveIndex < d->m_drives.size(); ++driveIndex) {
+        d->samplingTasks.push_back(scheduler.addTask("drive.temperature", driveTemperaturePolicy(),
+            [pPrivate, driveIndex]() -> std::optional<double> {
+                const auto temperature = pPrivate->m_drives[driveIndex].sampleTemperature();
+                std::lock_guard lock(pPrivate->dynamicMx);
+                pPrivate->m_drives[driveIndex].setTemperature(temperature);
+                return temperature;
+            }));
+    }
+    scheduler.start();
+}
 
 nlohmann::json DriveManager::processInfoRequestPrivate(const std::string& uuid)
 {
@@ -178,7 +237,15 @@ nlohmann::json DriveManager::processInfoRequestPrivate(const std::string& uuid)
 nlohmann::json
 DriveManager::processDynamicRequestPrivate(const std::string& uuid)
 {
+    // Without the scheduler the values are sampled on request, as before
+    if (d->samplingTasks.empty()) {
+        for (auto& drive : d->m_drives) {
+            drive.setTemperature(drive.sampleTemperature());
+        }
+    }
+
     nlohmann::json result, resultPart;
+    std::lock_guard lock(d->dynamicMx);
     for (auto& drive : d->m_drives) {
         result.push_back(drive.getDynamicParameters());
     }
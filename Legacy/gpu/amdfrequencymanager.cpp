@@ -13,6 +13,8 @@
 #include <Libraries/Datawork/Numberic.hpp>
 #include <Libraries/Processes/ProcessInvoker.hpp>
 
+#include <Components/SystemProcessing/FsRoot.h>
+
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 #include <regex>
@@ -169,9 +171,9 @@ int64_t getCurrentVoltage(const std::string& freqFileData) {
 
 AMDFrequencyManager::AMDFrequencyManager(int64_t gpuId) :
     AbstractFrequencyManager(gpuId),
-    m_configFreqFilePath{std::string("/sys/class/drm/card") + m_gpuId + "/device/pp_od_clk_voltage"},
-    m_currentCoreFreqFilePath{std::string("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_sclk"},
-    m_currentMemFreqFilePath{std::string("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_mclk"}
+    m_configFreqFilePath{SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/pp_od_clk_voltage"},
+    m_currentCoreFreqFilePath{SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_sclk"},
+    m_currentMemFreqFilePath{SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_mclk"}
 
 {
     setupHwmonDir();
@@ -180,9 +182,9 @@ AMDFrequencyManager::AMDFrequencyManager(int64_t gpuId) :
 
 AMDFrequencyManager::AMDFrequencyManager(const std::string& gpuId) :
     AbstractFrequencyManager(gpuId),
-    m_configFreqFilePath{std::string("/sys/class/drm/card") + m_gpuId + "/device/pp_od_clk_voltage"},
-    m_currentCoreFreqFilePath{std::string("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_sclk"},
-    m_currentMemFreqFilePath{std::string("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_mclk"}
+    m_configFreqFilePath{SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/pp_od_clk_voltage"},
+    m_currentCoreFreqFilePath{SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_sclk"},
+    m_currentMemFreqFilePath{SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/pp_dpm_mclk"}
 {
     setupHwmonDir();
     updateFreqs();
@@ -270,6 +272,11 @@ FrequencyValue_t AMDFrequencyManager::getCurrentCoreFreq() const
     return getCurrentFreq(fileReadBuffer);
 }
 
+FrequencyValue_t AMDFrequencyManager::parseCurrentFreq(const std::string &dpmData)
+{
+    return getCurrentFreq(dpmData);
+}
+
 FrequencyValue_t AMDFrequencyManager::getCurrentMemoryLock() const
 {
     COMPLOG_ERROR("AMD: Get current memory lock");
@@ -405,7 +412,7 @@ FrequencyValue_t AMDFrequencyManager::getDefaultMemoryVoltage() const
 
 void AMDFrequencyManager::setupHwmonDir()
 {
-    auto hwmonDirBase = std::string("/sys/class/drm/card") + m_gpuId + "/device/hwmon";
+    auto hwmonDirBase = SystemProcessing::FsRoot::path("/sys/class/drm/card") + m_gpuId + "/device/hwmon";
 
     auto hwmonFiles = Libraries::FileworkUtil::getContentPaths(hwmonDirBase, "hwmon[0-9]+");
     if (hwmonFiles.empty()) {
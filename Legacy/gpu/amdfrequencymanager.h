@@ -41,6 +41,9 @@ public:
     FrequencyValue_t getDefaultMemoryClock() const override;
     FrequencyValue_t getDefaultMemoryVoltage() const override;
 
+    // Current level of pp_dpm_sclk / pp_dpm_mclk content (the line marked with *)
+    static FrequencyValue_t parseCurrentFreq(const std::string& dpmData);
+
 private:
     const std::string m_configFreqFilePath;
     const std::string m_currentCoreFreqFilePath;
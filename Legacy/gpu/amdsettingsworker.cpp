@@ -5,6 +5,8 @@
 #include <Libraries/Processes/ProcessInvoker.hpp>
 #include <Libraries/Filework/FileworkUtils.hpp>
 
+#include <Components/SystemProcessing/FsRoot.h>
+
 #include <algorithm>
 #include <cstring>
 #include <dirent.h>
@@ -37,7 +39,7 @@ void AMDSettingsWorker::init(int64_t gpuId)
 {
     this->gpuId = gpuId;
     setSettingsDir("");
-    const std::string cardPath = "/sys/class/drm/card" + std::to_string(gpuId) + "/device/hwmon";
+    const std::string cardPath = SystemProcessing::FsRoot::path("/sys/class/drm/card") + std::to_string(gpuId) + "/device/hwmon";
 
     DIR* cardDirectory;
     struct dirent* dirEntry;
@@ -11,6 +11,10 @@
 #include "amdfrequencymanager.h"
 #include "nvidiafrequencymanager.h"
 
+#include <Components/SystemProcessing/FsRoot.h>
+#include <Components/SystemProcessing/NumaTopology.h>
+#include <Components/SystemProcessing/SysfsBatchReader.h>
+
 #include <NVML/nvml.h>
 #include <NVCtrl/NVCtrl.h>
 #include <NVCtrl/NVCtrlLib.h>
@@ -33,6 +37,32 @@ struct GPUCard::GPUCardPrivate
 
     std::shared_ptr<CardSettingsWorker>     settingsWorker;
     std::shared_ptr<AbstractFrequencyManager>       freqManager;
+
+    // Slots of the AMD sysfs files in GPUManager's batch
+    struct SysfsSlots {
+        size_t coreFreq         {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+        size_t memoryFreq       {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+        size_t coreVoltage      {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+        size_t temperature      {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+        size_t temperatureMax   {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+        size_t fan              {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+        size_t power            {SystemProcessing::SysfsBatchReader::INVALID_SLOT};
+    } sysfsSlots;
+    bool isSysfsBatched {false};
+
+    // Values of the last batch, getDynamic() reports them instead of reading the files again
+    Libraries::JOptional<int64_t> batchPower;
+    Libraries::JOptional<int64_t> batchTemperature;
+    Libraries::JOptional<int64_t> batchFan;
+
+    static Libraries::JOptional<int64_t> scaledValue(const SystemProcessing::SysfsBatchReader& batch, size_t slot, double scale)
+    {
+        int64_t value {0};
+        if (!batch.value(slot, value)) {
+            return {};
+        }
+        return static_cast<int64_t>(value * scale);
+    }
 };
 
 nlohmann::json GPUCard::getFullInformation() const
@@ -45,6 +75,7 @@ nlohmann::json GPUCard::getFullInformation() const
 
         pci["id"]     = Libraries::safeSton<int64_t, 16>(d->parameters.busInfo.tryGetValue());
         pci["bus"]    = d->parameters.pciInfoString;
+        pci["numaNode"] = SystemProcessing::NumaTopology::pciDeviceNode(d->parameters.pciInfoString);
     result["pci"] = pci;
 
         fan["rangeValue"] = d->parameters.fan.info(true);
@@ -224,6 +255,61 @@ void GPUCard::updateDynamic()
     d->parameters.powerLimit.current = d->settingsWorker->getPowerCurrent().tryGetValue();
 }
 
+void GPUCard::registerSysfsReads(SystemProcessing::SysfsBatchReader &batch)
+{
+    if (m_vendor != GPU_CARD_VENDOR::GPU_CARD_VENDOR_AMD) {
+        return;
+    }
+
+    const std::string deviceDir = SystemProcessing::FsRoot::path("/sys/class/drm/card") +
+                                  std::to_string(d->parameters.actualId.tryGetValue()) + "/device";
+    auto& slots = d->sysfsSlots;
+    slots.coreFreq   = batch.add(deviceDir + "/pp_dpm_sclk");
+    slots.memoryFreq = batch.add(deviceDir + "/pp_dpm_mclk");
+
+    auto hwmonDirs = Libraries::FileworkUtil::getContentPaths(deviceDir + "/hwmon", "hwmon[0-9]+");
+    if (!hwmonDirs.empty()) {
+        const auto& hwmonDir = hwmonDirs.front();
+        slots.coreVoltage    = batch.add(hwmonDir + "/in0_input", 64);
+        slots.temperature    = batch.add(hwmonDir + "/temp1_input", 64);
+        slots.temperatureMax = batch.add(hwmonDir + "/temp1_crit", 64);
+        slots.fan            = batch.add(hwmonDir + "/pwm1", 64);
+
+        // Same fallback as AMDSettingsWorker::getPowerCurrent()
+        slots.power = batch.add(hwmonDir + "/power1_average", 64);
+        if (slots.power == SystemProcessing::SysfsBatchReader::INVALID_SLOT) {
+            slots.power = batch.add(hwmonDir + "/power1_input", 64);
+        }
+    }
+    d->isSysfsBatched = true;
+}
+
+void GPUCard::updateDynamic(const SystemProcessing::SysfsBatchReader &batch)
+{
+    if (!d->isSysfsBatched) {
+        updateDynamic();
+        return;
+    }
+
+    const auto& slots = d->sysfsSlots;
+    if (batch.isValid(slots.coreFreq)) {
+        d->parameters.coreClock.info.current = AMDFrequencyManager::parseCurrentFreq(std::string(batch.value(slots.coreFreq)));
+    }
+    if (batch.isValid(slots.memoryFreq)) {
+        d->parameters.memoryClock.info.current = AMDFrequencyManager::parseCurrentFreq(std::string(batch.value(slots.memoryFreq)));
+    }
+    d->parameters.coreVoltage.info.current = GPUCardPrivate::scaledValue(batch, slots.coreVoltage, 1);
+    d->parameters.memVoltage.info.current  = d->freqManager->getCurrentMemVoltage();
+
+    d->batchTemperature = GPUCardPrivate::scaledValue(batch, slots.temperature, 1e-3);
+    d->batchFan         = GPUCardPrivate::scaledValue(batch, slots.fan, 1);
+    d->batchPower       = GPUCardPrivate::scaledValue(batch, slots.power, 1e-6);
+
+    d->parameters.temperature.maxVal  = GPUCardPrivate::scaledValue(batch, slots.temperatureMax, 1e-3);
+    d->parameters.temperature.current = d->batchTemperature;
+    d->parameters.fan.info.current    = d->batchFan;
+    d->parameters.powerLimit.current  = d->batchPower.tryGetValue();
+}
 
 void GPUCard::setOverclock(const Libraries::Internal::OverclockParameters &paramStruct)
 {
@@ -253,7 +339,7 @@ bool GPUCard::isConnected() const
 {
     bool isConnected = false;
 
-    const std::string modaliasFilePath = std::string("/sys/class/drm/card") +
+    const std::string modaliasFilePath = SystemProcessing::FsRoot::path("/sys/class/drm/card") +
                                          d->parameters.physId.tryGetValue() +
                                          "/device/modalias";
     isConnected = stdfs::exists(modaliasFilePath);
@@ -265,6 +351,21 @@ nlohmann::json GPUCard::getDynamic()
     nlohmann::json result;
 
     result["id"]          = uuid();
+    if (d->isSysfsBatched) {
+        result["power"]       = d->batchPower;
+        result["temperature"] = d->batchTemperature;
+        result["fan"]         = d->batchFan;
+
+        result["clock"]       = {};
+            result["clock"]["core"]          = d->parameters.coreClock.info.current;
+            result["clock"]["memory"]        = d->parameters.memoryClock.info.current;
+
+        result["voltage"]     = {};
+            result["voltage"]["core"]          = d->parameters.coreVoltage.info.current;
+            result["voltage"]["memory"]        = d->parameters.memVoltage.info.current;
+        return result;
+    }
+
     result["power"]       = d->settingsWorker->getPowerCurrent();
     result["temperature"] = d->settingsWorker->getTempCurrent();
     result["fan"]         = d->settingsWorker->getFanCurrent();
@@ -9,6 +9,11 @@
 
 typedef void PDisplay;
 
+namespace SystemProcessing
+{
+class SysfsBatchReader;
+}
+
 namespace Hardware
 {
 namespace GPU
@@ -45,6 +50,11 @@ class GPUCard
 
     void init();
     void updateDynamic();
+
+    // Batched sweep: files are registered once, GPUManager reads the whole batch per request
+    void registerSysfsReads(SystemProcessing::SysfsBatchReader& batch);
+    void updateDynamic(const SystemProcessing::SysfsBatchReader& batch);
+
     void setOverclock(const Libraries::Internal::OverclockParameters& paramStruct);
     bool isConnected() const;
 
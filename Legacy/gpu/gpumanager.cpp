@@ -22,6 +22,12 @@
 
 #include "gpucard.hpp"
 
+#include <Components/SystemProcessing/AdaptiveScheduler.h>
+#include <Components/SystemProcessing/SysfsBatchReader.h>
+#include <Components/SystemProcessing/TraceRecorder.h>
+
+#include <mutex>
+
 namespace Hardware
 {
 
@@ -33,6 +39,41 @@ struct GPUManager::GPUManagerPrivate {
     std::shared_ptr<PDisplay> pDisplay;
     bool nvidiaCanWork = false;
 
+    // Every AMD sysfs file of a dynamic sweep, read in one pass
+    SystemProcessing::SysfsBatchReader sysfsBatch;
+    std::mutex sweepMx;
+
+    // Result of the last sweep of the adaptive scheduler, served to dynamic requests
+    std::mutex dynamicMx;
+    nlohmann::json cachedDynamic;
+    int samplingTask {0};
+
+    ~GPUManagerPrivate()
+    {
+        if (samplingTask != 0) {
+            SystemProcessing::AdaptiveScheduler::getInstance().removeTask(samplingTask);
+        }
+    }
+
+    nlohmann::json sweepDynamic(double& oMaxTemperature)
+    {
+        std::lock_guard lock(sweepMx);
+        sysfsBatch.readAll();
+
+        nlohmann::json result;
+        oMaxTemperature = 0;
+        for (auto gpu : m_gpus)
+        {
+            gpu->updateDynamic(sysfsBatch);
+            auto gpuDynamic = gpu->getDynamic();
+            if (gpuDynamic["temperature"].is_number()) {
+                oMaxTemperature = std::max(oMaxTemperature, gpuDynamic["temperature"].get<double>());
+            }
+            result.push_back(std::move(gpuDynamic));
+        }
+        return result;
+    }
+
     static int x11ErrorHandler(Display *display, XErrorEvent *error) {
         char errorText[256];
         XGetErrorText(display, error->error_code, errorText, sizeof(errorText));
@@ -169,6 +210,8 @@ void GPUManager::parseNodeTree()
 
 void GPUManager::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "gpu.manager.init");
+
     d = std::make_shared<GPUManagerPrivate>();
 
     parseNodeTree();
@@ -221,6 +264,7 @@ void GPUManager::init()
         if (pCard.use_count()) {
             pCard->setGpuCardParameters(gpuInfo);
             pCard->init();
+            pCard->registerSysfsReads(d->sysfsBatch);
             d->m_gpus.push_back(pCard);
         }
     }
@@ -228,7 +272,33 @@ void GPUManager::init()
     setInited();
 }
 
-void GPUManager::start() {}
+void GPUManager::start()
+{
+    if (!d || d->samplingTask != 0 || d->m_gpus.empty()) {
+        return;
+    }
+
+    // One task for the whole sweep, driven by the hottest card: a batch costs about as much as a single file
+    SystemProcessing::AdaptivePolicy policy;
+    policy.basePeriod      = std::chrono::seconds(1);
+    policy.minPeriod       = std::chrono::milliseconds(250);
+    policy.maxPeriod       = std::chrono::seconds(10);
+    policy.volatileDelta   = 3;
+    policy.stableDelta     = 1;
+    policy.threshold       = 85;
+    policy.thresholdMargin = 5;
+
+    auto pPrivate = d.get();
+    auto& scheduler = SystemProcessing::AdaptiveScheduler::getInstance();
+    d->samplingTask = scheduler.addTask("gpu.sweep", policy, [pPrivate]() -> std::optional<double> {
+        double maxTemperature {0};
+        auto dynamic = pPrivate->sweepDynamic(maxTemperature);
+        std::lock_guard lock(pPrivate->dynamicMx);
+        pPrivate->cachedDynamic = std::move(dynamic);
+        return maxTemperature;
+    });
+    scheduler.start();
+}
 
 nlohmann::json GPUManager::processInfoRequestPrivate(const std::string& uuid)
 {
@@ -247,16 +317,16 @@ nlohmann::json GPUManager::processInfoRequestPrivate(const std::string& uuid)
 
 nlohmann::json GPUManager::processDynamicRequestPrivate(const std::string& uuid)
 {
-    for (auto gpu : d->m_gpus)
-        gpu->updateDynamic();
-
-    nlohmann::json result;
-    for (auto gpu : d->m_gpus)
     {
-        gpu->updateDynamic();
-        result.push_back(gpu->getDynamic());
+        std::lock_guard lock(d->dynamicMx);
+        if (!d->cachedDynamic.is_null()) {
+            return d->cachedDynamic;
+        }
     }
-    return result;
+
+    // No sweep of the scheduler yet
+    double maxTemperature {0};
+    return d->sweepDynamic(maxTemperature);
 }
 
 bool GPUManager::processOverclockRequestPrivate(const nlohmann::json& payload,
@@ -5,6 +5,8 @@
 #include <Libraries/Processes/ProcessInvoker.hpp>
 #include <Libraries/Datawork/Numberic.hpp>
 
+#include <Components/SystemProcessing/ProbeStats.h>
+
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -248,6 +250,8 @@ FrequencyValue_t NvidiaFrequencyManager::getCurrentCoreVoltage() const
     std::string inputStr;
 
     // nvidia-smi -q --id=0 -d VOLTAGE
+    SYSTEMPROCESSING_PROBE(probe, "gpu.nvidia.voltage.nvidiaSmi");
+    probe.addSubprocess();
     if (!Libraries::ProcessInvoker::invoke("nvidia-smi", Libraries::StringList("-q", "--id=" + m_gpuId, "-d", "VOLTAGE"), inputStr)) {
         COMPLOG_ERROR("Error getting Nvidia core voltage for", m_gpuId);
         return 0;
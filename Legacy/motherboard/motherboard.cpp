@@ -6,6 +6,8 @@
 #include <Libraries/Constants/ConstantMaster.hpp>
 #include <Libraries/Datawork/HWNodesWork.hpp>
 
+#include <Components/SystemProcessing/TraceRecorder.h>
+
 #include <nlohmann/json.hpp>
 
 #include <regex>
@@ -40,6 +42,8 @@ struct Motherboard::MotherboardPrivate {
 
 void Motherboard::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "motherboard.init");
+
     d = std::make_shared<MotherboardPrivate>();
     parseNodeTree();
     setupPCISlots();
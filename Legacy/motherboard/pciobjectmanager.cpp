@@ -4,6 +4,8 @@
 #include <Libraries/Processes/ProcessInvoker.hpp>
 #include <Libraries/Etc/Logging.hpp>
 
+#include <Components/SystemProcessing/ProbeStats.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/tokenizer.hpp>
 
@@ -89,6 +91,8 @@ PCIObjectManager::~PCIObjectManager()
 
 void PCIObjectManager::updateObjectList()
 {
+    SYSTEMPROCESSING_PROBE(probe, "motherboard.pci.lspci");
+    probe.addSubprocess();
     std::string output, errorStr;
     if (!Libraries::ProcessInvoker::invoke("lspci", {}, output, errorStr, 10000)) {
         COMPLOG_ERROR("Error PCI info updating");
@@ -4,6 +4,8 @@
 #include <Libraries/Processes/ProcessInvoker.hpp>
 #include <Libraries/Etc/Logging.hpp>
 
+#include <Components/SystemProcessing/ProbeStats.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/tokenizer.hpp>
 
@@ -39,6 +41,8 @@ USBObjectManager::~USBObjectManager()
 
 void USBObjectManager::updateObjects()
 {
+    SYSTEMPROCESSING_PROBE(probe, "motherboard.usb.lsusb");
+    probe.addSubprocess();
     std::string output, errorStr;
     if (!Libraries::ProcessInvoker::invoke("lsusb", {}, output, errorStr, 10000)) {
         COMPLOG_ERROR("Error PCI info updating");
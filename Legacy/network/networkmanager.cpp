@@ -5,6 +5,10 @@
 #include <Libraries/Internal/Structures.hpp>
 #include <Libraries/Datawork/HWNodesWork.hpp>
 
+#include <Components/SystemProcessing/NumaTopology.h>
+#include <Components/SystemProcessing/ProbeStats.h>
+#include <Components/SystemProcessing/TraceRecorder.h>
+
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <netinet/in.h>
@@ -268,9 +272,13 @@ bool NetworkManager::connectWifi(const std::string& ssid,
 
 std::string NetworkManager::foreignIp(const std::string& interfaceLogicalName) const
 {
+    SYSTEMPROCESSING_PROBE(probe, "network.foreignIp.curl");
+    probe.addSubprocess();
     std::string output;
-    if (!Libraries::ProcessInvoker::invoke("curl", "-q ifconfig.me", output))
+    if (!Libraries::ProcessInvoker::invoke("curl", "-q ifconfig.me", output)) {
+        probe.fail();
         return "Error getting F-IP";
+    }
 //    COMPLOG_DEBUG("Foreign IP:", output);
     return output;
 
@@ -330,6 +338,8 @@ void NetworkManager::parseNodeTree()
 
 void NetworkManager::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "network.manager.init");
+
     d = std::make_shared<NetworkManagerPrivate>();
     updateAdaptorList();
 
@@ -369,6 +379,7 @@ NetworkManager::processInfoRequestPrivate(const std::string& uuid)
             adaptorInfo["size"]         = netAdaptor.speed;
             adaptorInfo["capacity"]     = netAdaptor.capacity;
             adaptorInfo["mac"]          = netAdaptor.serial;
+            adaptorInfo["numaNode"]     = SystemProcessing::NumaTopology::netDeviceNode(netAdaptor.logicalName);
         adaptorListPart["information"]  = adaptorInfo;
 
         adaptorList.push_back(adaptorListPart);
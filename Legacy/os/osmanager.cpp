@@ -6,6 +6,9 @@
 #include <Libraries/Processes/PackageManager.hpp>
 #include <Libraries/Processes/ProcessInvoker.hpp>
 
+#include <Components/SystemProcessing/TraceRecorder.h>
+#include <Components/SystemProcessing/ProbeStats.h>
+
 #include <future>
 
 namespace Hardware
@@ -74,29 +77,52 @@ void OSManager::setupOsInfo()
 {
     std::string output;
 
-    if (!Libraries::ProcessInvoker::invoke("uname", "-r", output)) {
-        d->conf.linuxKernelVersion = output;
+    // One probe per invoke, so each tool's fork and exec shows up as its own span
+    {
+        SYSTEMPROCESSING_PROBE(probe, "os.info.uname");
+        probe.addSubprocess();
+        if (!Libraries::ProcessInvoker::invoke("uname", "-r", output)) {
+            d->conf.linuxKernelVersion = output;
+        }
     }
 
-    if (!Libraries::ProcessInvoker::invoke("nvcc", "--version | grep -oP 'release \\K[0-9.]+'", output)) {
-        d->conf.cudaVersion = output;
+    {
+        SYSTEMPROCESSING_PROBE(probe, "os.info.nvcc");
+        probe.addSubprocess();
+        if (!Libraries::ProcessInvoker::invoke("nvcc", "--version | grep -oP 'release \\K[0-9.]+'", output)) {
+            d->conf.cudaVersion = output;
+        }
     }
 
-    if (!Libraries::ProcessInvoker::invoke("dkms", "status nvidia | grep -oP 'nvidia/\\K[^,]+' | sort -u", output)) {
-        d->conf.nvidiaDriverVersion = output;
+    {
+        SYSTEMPROCESSING_PROBE(probe, "os.info.dkms");
+        probe.addSubprocess();
+        if (!Libraries::ProcessInvoker::invoke("dkms", "status nvidia | grep -oP 'nvidia/\\K[^,]+' | sort -u", output)) {
+            d->conf.nvidiaDriverVersion = output;
+        }
     }
 
-    if (!Libraries::ProcessInvoker::invoke("apt", "show amdgpu-install 2> /dev/null | grep -oP \"Version: \\K[^ ]+\"", output)) {
-        d->conf.amdDriverVersion = output;
+    {
+        SYSTEMPROCESSING_PROBE(probe, "os.info.aptAmdgpu");
+        probe.addSubprocess();
+        if (!Libraries::ProcessInvoker::invoke("apt", "show amdgpu-install 2> /dev/null | grep -oP \"Version: \\K[^ ]+\"", output)) {
+            d->conf.amdDriverVersion = output;
+        }
     }
 
-    if (!Libraries::ProcessInvoker::invoke("apt", "show ocl-icd-opencl-dev 2> /dev/null | grep -oP \"Version: \\K[^ ]+\"", output)) {
-        d->conf.openclDriverVersion = output;
+    {
+        SYSTEMPROCESSING_PROBE(probe, "os.info.aptOpencl");
+        probe.addSubprocess();
+        if (!Libraries::ProcessInvoker::invoke("apt", "show ocl-icd-opencl-dev 2> /dev/null | grep -oP \"Version: \\K[^ ]+\"", output)) {
+            d->conf.openclDriverVersion = output;
+        }
     }
 }
 
 void OSManager::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "os.manager.init");
+
     d = std::make_shared<OSManagerPrivate>();
 
     // Setup packages (disabled on 18.01.2025 in case of useless)
@@ -4,7 +4,6 @@
 #include <Libraries/Etc/Logging.hpp>
 #include <Libraries/Internal/Structures.hpp>
 #include <Libraries/Processes/PackageManager.hpp>
-#include <Libraries/Processes/ProcessInvoker.hpp>
 
 #include <map>
 #include <regex>
@@ -12,8 +11,6 @@
 
 #include <unistd.h>
 
-#include <boost/tokenizer.hpp>
-
 namespace Hardware
 {
 
@@ -31,57 +28,41 @@ void RAMCard::dump()
     d->m_cardInfo.dump();
 }
 
-int64_t RAMCard::free() const
+const SystemProcessing::MeminfoReader& RAMCard::meminfoReader()
 {
-    // TODO: Get understand how the hell "free" gets used mem
-    //    if(sysinfo(&d->m_cardInfo.memInfo) == 0)
-    //        return d->m_cardInfo.memInfo.freeram;
-    //    else
-    //        return 0;
-
-    std::string output;
+    static const SystemProcessing::MeminfoReader reader;
+    return reader;
+}
 
-    if (!Libraries::ProcessInvoker::invoke("free", Libraries::StringList("--mega"), output)) {
-        COMPLOG_WARNING("Error getting free RAM");
-        return 0;
+SystemProcessing::MemoryStats RAMCard::readMemoryStats()
+{
+    SystemProcessing::MemoryStats stats;
+    if (!meminfoReader().read(stats)) {
+        COMPLOG_WARNING("Error reading /proc/meminfo");
     }
+    return stats;
+}
 
-    boost::tokenizer ramTokenizer(output);
-    int curPos = 0;
-    for (auto& tkn : ramTokenizer) {
-        if (curPos < 3) {
-            curPos++;
-            continue;
-        }
-        auto result = Libraries::safeSton<int64_t>(tkn).tryGetValue();
-        return result;
-    }
-    return {};
+int64_t RAMCard::free() const
+{
+    return readMemoryStats().free / 1000000; // In megabytes like "free --mega"
 }
 
 int64_t RAMCard::total() const
 {
-    if (sysinfo(&d->m_cardInfo.memInfo) == 0)
-        return d->m_cardInfo.memInfo.totalram / 1e6; // Not in bytes
-    else
-        return 0;
+    return readMemoryStats().total / 1000000; // Not in bytes
 }
 
 int64_t RAMCard::usage() const
 {
-    if (sysinfo(&d->m_cardInfo.memInfo) == 0)
-        return (d->m_cardInfo.memInfo.totalram -
-                d->m_cardInfo.memInfo.freeram) /
-               1048576;
-    else
-        return 0;
+    const auto stats = readMemoryStats();
+    return (stats.total - stats.free) / 1048576;
 }
 
 void RAMCard::init()
 {
     // Get dynamic-changing values
-    d->m_cardInfo.memorySpace.free  = this->free();
-    d->m_cardInfo.memorySpace.usage = this->usage();
+    updateDynamic(readMemoryStats());
 
     if (d->m_cardInfo.type == "Unknown")
         d->m_cardInfo.product += " (empty)";
@@ -93,8 +74,13 @@ void RAMCard::init()
 
 void RAMCard::updateDynamic()
 {
-    d->m_cardInfo.memorySpace.free  = this->free();
-    d->m_cardInfo.memorySpace.usage = this->usage();
+    updateDynamic(readMemoryStats());
+}
+
+void RAMCard::updateDynamic(const SystemProcessing::MemoryStats &stats)
+{
+    d->m_cardInfo.memorySpace.free  = stats.free / 1000000;
+    d->m_cardInfo.memorySpace.usage = (stats.total - stats.free) / 1048576;
 }
 
 std::string& RAMCard::uuid()
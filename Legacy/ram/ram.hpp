@@ -7,6 +7,8 @@
 
 #include <Libraries/Internal/AbstractHardware.hpp>
 
+#include <Components/SystemProcessing/MeminfoReader.h>
+
 namespace Hardware
 {
 class RAMCard
@@ -19,6 +21,7 @@ class RAMCard
 
     void init();
     void updateDynamic();
+    void updateDynamic(const SystemProcessing::MemoryStats& stats);
 
     std::string& uuid();
 
@@ -26,6 +29,10 @@ class RAMCard
     int64_t total() const;
     int64_t usage() const;
 
+    // One /proc/meminfo reader shared by all cards
+    static const SystemProcessing::MeminfoReader& meminfoReader();
+    static SystemProcessing::MemoryStats readMemoryStats();
+
   private:
     struct RAMCardPrivate;
     std::shared_ptr<RAMCardPrivate> d;
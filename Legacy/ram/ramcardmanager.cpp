@@ -9,6 +9,9 @@
 #include <Libraries/Processes/ProcessInvoker.hpp>
 #include <Libraries/Datawork/HWNodesWork.hpp>
 
+#include <Components/SystemProcessing/TraceRecorder.h>
+#include <Components/SystemProcessing/ProbeStats.h>
+
 #include <map>
 #include <regex>
 #include <string.h>
@@ -62,6 +65,8 @@ std::vector<std::string> createRamHandlerList()
 
     std::vector<std::string> ramHandlers;
 
+    SYSTEMPROCESSING_PROBE(probe, "ram.handlers.dmidecode");
+    probe.addSubprocess();
     std::string dmidecodeOutput;
     if (!Libraries::ProcessInvoker::invoke("dmidecode", " -t memory",
                                            dmidecodeOutput))
@@ -133,12 +138,16 @@ void RAMCardManager::dump()
 
 void RAMCardManager::updateDynamic()
 {
+    // System-wide values, one read for all cards
+    const auto memoryStats = RAMCard::readMemoryStats();
     for (auto& ram : d->ramCards)
-        ram.updateDynamic();
+        ram.updateDynamic(memoryStats);
 }
 
 void RAMCardManager::init()
 {
+    SYSTEMPROCESSING_TRACE(trace, "ram.manager.init");
+
     d = decltype(d)(new Impl);
 
     parseNodeTree();
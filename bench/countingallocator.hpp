@@ -0,0 +1,14 @@
+// Global operator new/delete replacement that counts heap allocations.
+// Linked into the benches that report allocations per operation.
+
+#pragma once
+
+#include <cstdint>
+
+namespace Bench
+{
+
+// Allocations made through any operator new since the process start
+uint64_t allocationsCount() noexcept;
+
+} // namespace Bench
@@ -0,0 +1,75 @@
+// Calls per second of the /proc/stat readers: the old ifstream-based parser
+// that StatusManager used before and ProcStatReader
+
+#include "../src/procstatreader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+using namespace SystemProcessing;
+
+constexpr auto BENCH_DURATION = std::chrono::seconds(1);
+
+// StatusManager::getCPUtimes() as it was before ProcStatReader
+bool legacyGetCPUtimes(size_t &idleTime, size_t &totalTime)
+{
+    std::ifstream proc_stat("/proc/stat");
+    proc_stat.ignore(5, ' ');
+    std::vector<size_t> times;
+    for (size_t time; proc_stat >> time; times.push_back(time));
+    if (times.size() < 4)
+        return false;
+    idleTime = times[3];
+    totalTime = std::accumulate(times.begin(), times.end(), 0);
+    return true;
+}
+
+template<typename Callable>
+void runBench(const char* name, Callable&& call)
+{
+    uint64_t calls = 0;
+    uint64_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    auto now = begin;
+    while (now - begin < BENCH_DURATION) {
+        for (int i = 0; i < 64; ++i) {
+            sink += call();
+        }
+        calls += 64;
+        now = std::chrono::steady_clock::now();
+    }
+    const double seconds = std::chrono::duration<double>(now - begin).count();
+    std::printf("%-32s %12.0f calls/s %10.0f ns/call (%lu)\n",
+                name, calls / seconds, seconds * 1e9 / calls, static_cast<unsigned long>(sink % 2));
+}
+
+} // namespace
+
+int main()
+{
+    runBench("ifstream aggregate (before)", []() {
+        size_t idleTime {}, totalTime {};
+        legacyGetCPUtimes(idleTime, totalTime);
+        return idleTime;
+    });
+
+    ProcStatReader reader;
+    runBench("ProcStatReader::readAggregate", [&reader]() {
+        CPUTimes times;
+        reader.readAggregate(times);
+        return times.idle();
+    });
+
+    CPUTimesTable table;
+    runBench("ProcStatReader::read (per-core)", [&reader, &table]() {
+        reader.read(table);
+        return table.aggregate.idle();
+    });
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Latency and heap allocations of one full DefaultSensorRegistry sweep.
+//   SystemProcessing_sweep_bench                       — this host
+//   SystemProcessing_sweep_bench record <dir> [frames] — record this host's /proc and /sys into a snapshot
+//   SystemProcessing_sweep_bench <dir>                 — replay a recorded GPU rig or server, frame per sweep
+
+#include "countingallocator.hpp"
+
+#include "../src/fsroot.hpp"
+#include "../src/sensorregistry.hpp"
+#include "../src/sysfsrecorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace SystemProcessing;
+
+constexpr int SWEEPS_COUNT = 500;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 && std::strcmp(argv[1], "record") == 0) {
+        const size_t framesCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10;
+        const auto filesCount = SysfsRecorder(argv[2]).record(framesCount);
+        std::printf("Recorded %zu frames, %zu files each, into %s\n", framesCount, filesCount, argv[2]);
+        return filesCount != 0 ? 0 : 1;
+    }
+
+    std::unique_ptr<SysfsReplayer> replayer;
+    if (argc > 1) {
+        replayer = std::make_unique<SysfsReplayer>(argv[1]);
+        if (!replayer->isOpened()) {
+            return 1;
+        }
+        FsRoot::set(replayer->root());
+    }
+
+    DefaultSensorRegistry registry;
+    const auto availableCount = registry.init();
+    DefaultSensorRegistry::Snapshot snapshot {};
+    registry.collect(snapshot); // Warm-up: first sweep sizes the reusable buffers
+
+    std::vector<double> sweepUs;
+    sweepUs.reserve(SWEEPS_COUNT);
+    uint64_t allocationsCount = 0;
+    for (int i = 0; i < SWEEPS_COUNT; ++i)
+    {
+        if (replayer) {
+            replayer->advance();
+        }
+        const auto allocationsBefore = Bench::allocationsCount();
+        const auto begin = std::chrono::steady_clock::now();
+        registry.collect(snapshot);
+        sweepUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+        allocationsCount += Bench::allocationsCount() - allocationsBefore;
+    }
+
+    std::sort(sweepUs.begin(), sweepUs.end());
+    std::printf("%zu of %zu collectors, %s, %zu frames\n", availableCount, DefaultSensorRegistry::COLLECTORS_COUNT,
+                replayer ? replayer->root().c_str() : "host", replayer ? replayer->framesCount() : size_t(1));
+    std::printf("sweep p50 %8.1f us  p99 %8.1f us  max %8.1f us  %6.2f allocations/sweep\n",
+                sweepUs[SWEEPS_COUNT / 2], sweepUs[SWEEPS_COUNT * 99 / 100], sweepUs.back(),
+                double(allocationsCount) / SWEEPS_COUNT);
+    return 0;
+}
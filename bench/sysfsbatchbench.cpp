@@ -0,0 +1,103 @@
+// Latency of one sensor sweep: every hwmon and amdgpu DPM file of the machine read
+// file by file with open/read/close (as FileworkUtil::readFileData does) and through SysfsBatchReader.
+// Pass a directory to sweep other files, e.g. a copy of a GPU rig's /sys tree
+
+#include "../src/sysfsbatchreader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+
+using namespace SystemProcessing;
+
+constexpr int SWEEPS_COUNT = 200;
+
+void collectFiles(const std::string& dirPath, int depth, std::vector<std::string>& oPaths)
+{
+    DIR* dir = opendir(dirPath.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    while (auto entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name == "." || name == ".." || name == "subsystem" || name == "driver" || name == "power") {
+            continue;
+        }
+        const std::string path = dirPath + "/" + name;
+        if (entry->d_type == DT_DIR || (entry->d_type == DT_LNK && depth > 0)) {
+            if (depth > 0) {
+                collectFiles(path, depth - 1, oPaths);
+            }
+            continue;
+        }
+        if (name.find("_input") != std::string::npos || name.find("pp_dpm_") == 0 ||
+            name.find("power1_") == 0 || name.find("fan") == 0 || name.find("pwm") == 0) {
+            oPaths.push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+size_t readFileByFile(const std::vector<std::string>& paths)
+{
+    size_t bytes = 0;
+    char buffer[4096];
+    for (auto& path : paths) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        const auto readBytes = read(fd, buffer, sizeof(buffer));
+        bytes += readBytes > 0 ? readBytes : 0;
+        close(fd);
+    }
+    return bytes;
+}
+
+template<typename Callable>
+void runBench(const char* name, size_t filesCount, Callable&& sweep)
+{
+    size_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < SWEEPS_COUNT; ++i) {
+        sink += sweep();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("%-28s %6zu files %10.1f us/sweep (%lu)\n",
+                name, filesCount, seconds * 1e6 / SWEEPS_COUNT, static_cast<unsigned long>(sink % 2));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    if (argc > 1) {
+        collectFiles(argv[1], 4, paths);
+    } else {
+        collectFiles("/sys/class/hwmon", 1, paths);
+        collectFiles("/sys/class/drm", 2, paths);
+    }
+
+    runBench("open/read/close per file", paths.size(), [&paths]() {
+        return readFileByFile(paths);
+    });
+
+    SysfsBatchReader batch;
+    for (auto& path : paths) {
+        batch.add(path);
+    }
+    runBench(batch.isUsingIoUring() ? "SysfsBatchReader (io_uring)" : "SysfsBatchReader (pread)", batch.size(), [&batch]() {
+        batch.readAll();
+        return batch.size();
+    });
+    return 0;
+}
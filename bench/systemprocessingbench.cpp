@@ -0,0 +1,423 @@
+// Google Benchmark suite of the component hot paths: StatusManager calls, /proc and /sys readers,
+// collectors, the modalias parser and the Legacy AMD pp_dpm parsers. Every benchmark reports allocations/op and read/write syscalls/op
+// (syscr + syscw of /proc/thread-self/io).
+// Runs against a fixture root: this host's /proc and /sys recorded by SysfsRecorder, plus a synthetic
+// coretemp chip and an amdgpu card, so results don't depend on the sensors of the build machine
+
+#include "countingallocator.hpp"
+
+#include "../Legacy/common/modaliasparser.hpp"
+#include "../src/cpufreqreader.hpp"
+#include "../src/fsroot.hpp"
+#include "../src/sensorregistry.hpp"
+#include "../src/statusmanager.hpp"
+#include "../src/sysfsrecorder.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/tokenizer.hpp>
+
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+
+using namespace SystemProcessing;
+
+uint64_t threadSyscallsCount()
+{
+    const int fd = ::open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    char buffer[512];
+    const auto readBytes = ::read(fd, buffer, sizeof(buffer));
+    ::close(fd);
+
+    // "syscr: 9\nsyscw: 0\n"
+    uint64_t result = 0;
+    std::string_view text(buffer, readBytes > 0 ? readBytes : 0);
+    for (std::string_view key : {"syscr: ", "syscw: "}) {
+        const auto keyPos = text.find(key);
+        uint64_t value = 0;
+        if (keyPos != std::string_view::npos) {
+            std::from_chars(text.data() + keyPos + key.size(), text.data() + text.size(), value);
+        }
+        result += value;
+    }
+    // The read of this file is counted too
+    return result > 0 ? result - 1 : 0;
+}
+
+/**
+ * Sets allocations/op and syscalls/op of the benchmark when it leaves the scope; created before the state loop
+ */
+class OpCounters
+{
+public:
+    explicit OpCounters(benchmark::State& state) :
+        m_state {state},
+        m_allocationsBefore {Bench::allocationsCount()},
+        m_syscallsBefore {threadSyscallsCount()}
+    {
+
+    }
+
+    ~OpCounters()
+    {
+        const auto syscallsCount = threadSyscallsCount() - m_syscallsBefore;
+        const auto allocationsCount = Bench::allocationsCount() - m_allocationsBefore;
+        m_state.counters["allocs/op"] = benchmark::Counter(allocationsCount, benchmark::Counter::kAvgIterations);
+        m_state.counters["syscalls/op"] = benchmark::Counter(syscallsCount, benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& m_state;
+    uint64_t m_allocationsBefore;
+    uint64_t m_syscallsBefore;
+};
+
+constexpr std::string_view PP_DPM_SCLK =
+        "0: 300Mhz\n1: 600Mhz\n2: 900Mhz *\n3: 1145Mhz\n4: 1215Mhz\n5: 1257Mhz\n6: 1300Mhz\n7: 1340Mhz\n";
+
+// OD_SCLK section of pp_od_clk_voltage after AMDFrequencyManager splits the file by "OD_"
+constexpr std::string_view OD_SCLK_SECTION =
+        "SCLK:\n0:        300MHz        750mV\n1:        600MHz        769mV\n2:        900MHz        881mV\n"
+        "3:       1145MHz        950mV\n4:       1215MHz       1000mV\n5:       1257MHz       1050mV\n"
+        "6:       1300MHz       1100mV\n7:       1340MHz       1150mV\n";
+
+// Hardware::GPU parsers from Legacy/gpu/amdfrequencymanager.cpp, which is not part of the build.
+// Libraries::safeSton is replaced by the same stoll with the error mapped to 0
+int64_t legacySafeSton(const std::string& text)
+{
+    try {
+        return std::stoll(text);
+    } catch (...) {
+        return 0;
+    }
+}
+
+std::vector<std::pair<int64_t, int64_t> > legacyGetFreqVect(const std::string& fileDataSection)
+{
+    std::vector<std::pair<int64_t, int64_t> > result;
+
+    std::vector<std::string> lines;
+    boost::iter_split(lines, fileDataSection, boost::first_finder("\n"));
+    if (lines.size() > 1) {
+        lines.erase(lines.begin());
+    }
+
+    std::pair<int64_t, int64_t> values;
+    int currentVal = 0;
+    std::regex erasematcher("[a-zA-Z]");
+
+    for (auto& line : lines) {
+        boost::tokenizer valuesTokenizer(line);
+        for (auto& val : valuesTokenizer) {
+            if (currentVal == 0) {
+                currentVal++;
+                continue;
+            }
+
+            auto numberOnlyStr = std::regex_replace(val, erasematcher, "");
+            if (currentVal == 1) {
+                values.first = legacySafeSton(numberOnlyStr);
+            } else {
+                values.second = legacySafeSton(numberOnlyStr);
+            }
+            currentVal++;
+        }
+        result.push_back(values);
+    }
+
+    return result;
+}
+
+int64_t legacyGetCurrentFreq(const std::string& freqFileData)
+{
+    std::vector<std::string> lines;
+    boost::iter_split(lines, freqFileData, boost::first_finder("\n"));
+
+    int currentVal = 0;
+    std::regex erasematcher("[a-zA-Z]");
+    std::regex currentMatcher("[*]");
+
+    std::vector<std::string> currentLines;
+    for (auto& line : lines) {
+        boost::iter_find(currentLines, line, boost::first_finder("*"));
+        if (currentLines.size() < 1) {
+            continue;
+        }
+
+        boost::tokenizer valuesTokenizer(line);
+        for (auto& val : valuesTokenizer) {
+            if (currentVal == 0) {
+                currentVal++;
+                continue;
+            }
+
+            auto numberOnlyStr = std::regex_replace(val, erasematcher, "");
+            if (currentVal == 1) {
+                return legacySafeSton(numberOnlyStr);
+            }
+
+            currentVal++;
+        }
+    }
+    return {};
+}
+
+void writeFixtureFile(const std::filesystem::path& filePath, std::string_view data)
+{
+    std::filesystem::create_directories(filePath.parent_path());
+    std::ofstream(filePath) << data;
+}
+
+/**
+ * Records the host into a temporary snapshot, adds the synthetic devices and makes it the FsRoot
+ */
+std::unique_ptr<SysfsReplayer> setupFixtureRoot()
+{
+    char snapshotDir[] = "/tmp/systemprocessing-bench-XXXXXX";
+    if (::mkdtemp(snapshotDir) == nullptr) {
+        return {};
+    }
+    SysfsRecorder(snapshotDir).record(1, std::chrono::milliseconds(0), {
+        {"/proc/stat", 0},
+        {"/proc/meminfo", 0},
+        {"/proc/cpuinfo", 0},
+        {"/proc/diskstats", 0},
+        {"/proc/net/dev", 0},
+        {"/proc/pressure", 0},
+        {"/sys/devices/system/cpu", 2},
+        {"/sys/fs/cgroup", 0},
+    });
+
+    const std::filesystem::path frameDir = std::string(snapshotDir) + "/frames/0000";
+    const auto hwmonDir = frameDir / "sys/class/hwmon/hwmon0";
+    writeFixtureFile(hwmonDir / "name", "coretemp\n");
+    writeFixtureFile(hwmonDir / "temp1_input", "45000\n");
+    writeFixtureFile(hwmonDir / "temp1_label", "Package id 0\n");
+    writeFixtureFile(hwmonDir / "temp2_input", "43000\n");
+    writeFixtureFile(hwmonDir / "temp2_label", "Core 0\n");
+
+    const auto deviceDir = frameDir / "sys/class/drm/card0/device";
+    writeFixtureFile(deviceDir / "vendor", "0x1002\n");
+    writeFixtureFile(deviceDir / "modalias", "pci:v00001002d000067DFsv0000148Csd00002379bc03sc00i00\n");
+    writeFixtureFile(deviceDir / "gpu_busy_percent", "37\n");
+    writeFixtureFile(deviceDir / "mem_info_vram_used", "1073741824\n");
+    writeFixtureFile(deviceDir / "pp_dpm_sclk", PP_DPM_SCLK);
+    writeFixtureFile(deviceDir / "hwmon/hwmon1/temp1_input", "61000\n");
+    writeFixtureFile(deviceDir / "hwmon/hwmon1/power1_average", "121000000\n");
+
+    auto replayer = std::make_unique<SysfsReplayer>(snapshotDir);
+    FsRoot::set(replayer->root());
+    return replayer;
+}
+
+void BM_StatusManager_getCPULoad_Sampling(benchmark::State& state)
+{
+    StatusManager manager;
+    manager.startSampling(std::chrono::milliseconds(10));
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.getCPULoad());
+    }
+}
+BENCHMARK(BM_StatusManager_getCPULoad_Sampling);
+
+// Without the sampler: two /proc/stat reads around the window, here with the zero window to leave only the reads
+void BM_StatusManager_getCPULoad_Blocking(benchmark::State& state)
+{
+    StatusManager manager;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.getCPULoad(std::chrono::milliseconds(0)));
+    }
+}
+BENCHMARK(BM_StatusManager_getCPULoad_Blocking);
+
+void BM_StatusManager_getCPUCurrentTemperature(benchmark::State& state)
+{
+    StatusManager manager;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.getCPUCurrentTemperature());
+    }
+}
+BENCHMARK(BM_StatusManager_getCPUCurrentTemperature);
+
+// getCPUtimes() of StatusManager became ProcStatReader: aggregate line and the per core table
+void BM_ProcStatReader_readAggregate(benchmark::State& state)
+{
+    ProcStatReader reader;
+    CPUTimes times;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.readAggregate(times));
+    }
+}
+BENCHMARK(BM_ProcStatReader_readAggregate);
+
+void BM_ProcStatReader_read(benchmark::State& state)
+{
+    ProcStatReader reader;
+    CPUTimesTable table;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.read(table));
+    }
+}
+BENCHMARK(BM_ProcStatReader_read);
+
+void BM_MeminfoReader_read(benchmark::State& state)
+{
+    MeminfoReader reader;
+    MemoryStats stats;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.read(stats));
+    }
+}
+BENCHMARK(BM_MeminfoReader_read);
+
+void BM_NetDevReader_read(benchmark::State& state)
+{
+    NetDevReader reader;
+    std::vector<NetworkInterfaceStats> interfaces;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.read(interfaces));
+    }
+}
+BENCHMARK(BM_NetDevReader_read);
+
+void BM_DiskStatsReader_read(benchmark::State& state)
+{
+    DiskStatsReader reader;
+    std::vector<DiskStats> disks;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.read(disks));
+    }
+}
+BENCHMARK(BM_DiskStatsReader_read);
+
+void BM_CpufreqReader_read(benchmark::State& state)
+{
+    CpufreqReader reader;
+    CPUFrequencies frequencies;
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.read(frequencies));
+    }
+}
+BENCHMARK(BM_CpufreqReader_read);
+
+// Sensor tree search: chip directories scan and the CPU temperature lookup done once per StatusManager
+void BM_HwmonRegistry_scan(benchmark::State& state)
+{
+    OpCounters counters(state);
+    for (auto _ : state) {
+        HwmonRegistry registry;
+        benchmark::DoNotOptimize(registry.findCPUTemperature());
+    }
+}
+BENCHMARK(BM_HwmonRegistry_scan);
+
+void BM_ModaliasParser(benchmark::State& state)
+{
+    const std::string modalias = "pci:v00001002d000067DFsv0000148Csd00002379bc03sc00i00";
+    OpCounters counters(state);
+    for (auto _ : state) {
+        Hardware::GPU::ModaliasParser parser(modalias);
+        benchmark::DoNotOptimize(parser.getDID());
+    }
+}
+BENCHMARK(BM_ModaliasParser);
+
+// AMDFrequencyManager::getCurrentCoreFreq after the file is read: the "*" level of pp_dpm_sclk
+void BM_AMDLegacy_getCurrentFreq(benchmark::State& state)
+{
+    const std::string dpmData(PP_DPM_SCLK);
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyGetCurrentFreq(dpmData));
+    }
+}
+BENCHMARK(BM_AMDLegacy_getCurrentFreq);
+
+// AMDFrequencyManager::init: frequency and voltage levels of one pp_od_clk_voltage section
+void BM_AMDLegacy_getFreqVect(benchmark::State& state)
+{
+    const std::string section(OD_SCLK_SECTION);
+    OpCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyGetFreqVect(section));
+    }
+}
+BENCHMARK(BM_AMDLegacy_getFreqVect);
+
+#if SYSTEMPROCESSING_WITH_AMDGPU
+// Busy, VRAM, temperature and power of the card in one SysfsBatchReader pass
+void BM_AMDGPUCollector_collect(benchmark::State& state)
+{
+    AMDGPUCollector collector;
+    if (!collector.init()) {
+        state.SkipWithError("No amdgpu card in the fixture root");
+        return;
+    }
+    AMDGPUCollector::Sample sample {};
+    OpCounters counters(state);
+    for (auto _ : state) {
+        collector.collect(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_AMDGPUCollector_collect);
+#endif
+
+void BM_DefaultSensorRegistry_collect(benchmark::State& state)
+{
+    DefaultSensorRegistry registry;
+    registry.init();
+    DefaultSensorRegistry::Snapshot snapshot {};
+    registry.collect(snapshot);
+    OpCounters counters(state);
+    for (auto _ : state) {
+        registry.collect(snapshot);
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+BENCHMARK(BM_DefaultSensorRegistry_collect);
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto fixtureRoot = setupFixtureRoot();
+    if (!fixtureRoot || !fixtureRoot->isOpened()) {
+        return 1;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::filesystem::remove_all(std::filesystem::path(fixtureRoot->root()).parent_path());
+    return 0;
+}
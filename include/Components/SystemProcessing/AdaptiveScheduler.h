@@ -0,0 +1 @@
+#include "../../../src/adaptivescheduler.hpp"
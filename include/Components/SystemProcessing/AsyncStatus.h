@@ -0,0 +1 @@
+#include "../../../src/asyncstatus.hpp"
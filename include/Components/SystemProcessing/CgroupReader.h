@@ -0,0 +1 @@
+#include "../../../src/cgroupreader.hpp"
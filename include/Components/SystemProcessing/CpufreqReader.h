@@ -0,0 +1 @@
+#include "../../../src/cpufreqreader.hpp"
@@ -0,0 +1 @@
+#include "../../../src/diskstatsreader.hpp"
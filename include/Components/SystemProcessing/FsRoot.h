@@ -0,0 +1 @@
+#include "../../../src/fsroot.hpp"
@@ -0,0 +1 @@
+#include "../../../src/hwmonregistry.hpp"
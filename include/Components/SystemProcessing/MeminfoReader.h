@@ -0,0 +1 @@
+#include "../../../src/meminforeader.hpp"
@@ -0,0 +1 @@
+#include "../../../src/metrichistory.hpp"
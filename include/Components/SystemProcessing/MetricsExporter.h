@@ -0,0 +1 @@
+#include "../../../src/metricsexporter.hpp"
@@ -0,0 +1 @@
+#include "../../../src/netdevreader.hpp"
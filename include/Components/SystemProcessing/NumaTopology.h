@@ -0,0 +1 @@
+#include "../../../src/numatopology.hpp"
@@ -0,0 +1 @@
+#include "../../../src/perfcounters.hpp"
@@ -0,0 +1 @@
+#include "../../../src/pressuremonitor.hpp"
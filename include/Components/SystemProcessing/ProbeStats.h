@@ -0,0 +1 @@
+#include "../../../src/probestats.hpp"
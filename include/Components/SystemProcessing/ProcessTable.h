@@ -0,0 +1 @@
+#include "../../../src/processtable.hpp"
@@ -0,0 +1 @@
+#include "../../../src/raplreader.hpp"
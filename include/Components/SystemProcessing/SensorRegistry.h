@@ -0,0 +1 @@
+#include "../../../src/sensorregistry.hpp"
@@ -0,0 +1 @@
+#include "../../../src/sharedsnapshot.hpp"
@@ -0,0 +1 @@
+#include "../../../src/statussnapshot.hpp"
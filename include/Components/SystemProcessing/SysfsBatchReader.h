@@ -0,0 +1 @@
+#include "../../../src/sysfsbatchreader.hpp"
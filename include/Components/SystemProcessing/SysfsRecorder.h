@@ -0,0 +1 @@
+#include "../../../src/sysfsrecorder.hpp"
@@ -0,0 +1 @@
+#include "../../../src/thresholdevaluator.hpp"
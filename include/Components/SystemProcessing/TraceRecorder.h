@@ -0,0 +1 @@
+#include "../../../src/tracerecorder.hpp"
@@ -0,0 +1,325 @@
+#include "adaptivescheduler.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// With the default 10 ms tick one turn of the wheel is 5.12 s; longer periods wait for extra rounds
+constexpr size_t WHEEL_SIZE = 512;
+
+struct ScheduledTask
+{
+    int id {0};
+    std::string name;
+    AdaptivePolicy policy;
+    SamplingTask task;
+
+    std::chrono::milliseconds period {0};
+    std::optional<double> lastValue;
+    uint64_t runs {0};
+
+    size_t slot {0};
+    uint64_t rounds {0};    // Full turns of the wheel left before the task is due
+    bool isRemoved {false};
+    bool isDispatched {false};  // Queued or running on the blocking worker, off the wheel
+};
+
+std::optional<double> runTask(ScheduledTask& task) noexcept
+{
+    try {
+        return task.task();
+    } catch (const std::exception& ex) {
+        COMPLOG_ERROR("Sampling task failed:", task.name, ex.what());
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+struct AdaptiveScheduler::SchedulerPrivate
+{
+    std::chrono::milliseconds tick;
+
+    mutable std::mutex mx;
+    std::condition_variable cv;
+    std::unordered_map<int, std::shared_ptr<ScheduledTask>> tasks;
+    int nextTaskId {1};
+
+    std::array<std::vector<std::shared_ptr<ScheduledTask>>, WHEEL_SIZE> wheel;
+    size_t cursor {0};
+
+    std::thread thread;
+    bool stopRequested {false};
+    int runningTaskId {0};
+
+    // Subprocess-backed tasks take hundreds of ms and would stall the wheel
+    std::thread blockingThread;
+    std::condition_variable blockingCv;
+    std::deque<std::shared_ptr<ScheduledTask>> blockingQueue;
+    int blockingTaskId {0};
+
+    void schedule(const std::shared_ptr<ScheduledTask>& pTask, std::chrono::milliseconds delay)
+    {
+        const uint64_t ticks = std::max<uint64_t>(1, delay / tick);
+        pTask->slot = (cursor + ticks) % WHEEL_SIZE;
+        pTask->rounds = (ticks - 1) / WHEEL_SIZE;
+        wheel[pTask->slot].push_back(pTask);
+    }
+
+    void unschedule(const std::shared_ptr<ScheduledTask>& pTask)
+    {
+        auto& slotTasks = wheel[pTask->slot];
+        slotTasks.erase(std::remove(slotTasks.begin(), slotTasks.end(), pTask), slotTasks.end());
+    }
+
+    // Called under mx once the task has returned
+    void finishRun(const std::shared_ptr<ScheduledTask>& pTask, std::optional<double> value)
+    {
+        pTask->isDispatched = false;
+        if (pTask->isRemoved) {
+            return;
+        }
+        ++pTask->runs;
+        if (value.has_value()) {
+            pTask->period = nextPeriod(pTask->policy, pTask->period, pTask->lastValue, *value);
+            pTask->lastValue = value;
+        }
+        schedule(pTask, pTask->period);
+    }
+
+    void runBlocking()
+    {
+        std::unique_lock lock(mx);
+        while (true)
+        {
+            blockingCv.wait(lock, [this]() { return stopRequested || !blockingQueue.empty(); });
+            if (stopRequested) {
+                break;
+            }
+
+            auto pTask = std::move(blockingQueue.front());
+            blockingQueue.pop_front();
+            if (pTask->isRemoved) {
+                continue;
+            }
+
+            blockingTaskId = pTask->id;
+            lock.unlock();
+            const auto value = runTask(*pTask);
+            lock.lock();
+            blockingTaskId = 0;
+            cv.notify_all();
+
+            finishRun(pTask, value);
+        }
+    }
+
+    void run()
+    {
+        std::vector<std::shared_ptr<ScheduledTask>> dueTasks;
+        auto nextTick = std::chrono::steady_clock::now();
+
+        std::unique_lock lock(mx);
+        while (!stopRequested)
+        {
+            // A late loop doesn't sleep until it has caught up with the wall clock
+            nextTick += tick;
+            if (cv.wait_until(lock, nextTick, [this]() { return stopRequested; })) {
+                break;
+            }
+
+            cursor = (cursor + 1) % WHEEL_SIZE;
+            auto& slotTasks = wheel[cursor];
+            dueTasks.clear();
+            for (size_t i = 0; i < slotTasks.size();) {
+                if (slotTasks[i]->rounds > 0) {
+                    --slotTasks[i]->rounds;
+                    ++i;
+                    continue;
+                }
+                dueTasks.push_back(std::move(slotTasks[i]));
+                slotTasks[i] = std::move(slotTasks.back());
+                slotTasks.pop_back();
+            }
+
+            for (auto& pTask : dueTasks)
+            {
+                if (pTask->isRemoved) {
+                    continue;
+                }
+                if (pTask->policy.isBlocking) {
+                    pTask->isDispatched = true;
+                    blockingQueue.push_back(std::move(pTask));
+                    blockingCv.notify_one();
+                    continue;
+                }
+
+                runningTaskId = pTask->id;
+                lock.unlock();
+                const auto value = runTask(*pTask);
+                lock.lock();
+                runningTaskId = 0;
+                cv.notify_all();
+
+                finishRun(pTask, value);
+            }
+        }
+    }
+};
+
+AdaptiveScheduler::AdaptiveScheduler(std::chrono::milliseconds tick) :
+    d{new SchedulerPrivate}
+{
+    d->tick = std::max(tick, std::chrono::milliseconds(1));
+}
+
+AdaptiveScheduler::~AdaptiveScheduler()
+{
+    stop();
+}
+
+AdaptiveScheduler &AdaptiveScheduler::getInstance()
+{
+    static AdaptiveScheduler instance;
+    return instance;
+}
+
+int AdaptiveScheduler::addTask(const std::string &name, const AdaptivePolicy &policy, SamplingTask task)
+{
+    auto pTask = std::make_shared<ScheduledTask>();
+    pTask->name = name;
+    pTask->policy = policy;
+    pTask->task = std::move(task);
+    pTask->period = std::clamp(policy.basePeriod, policy.minPeriod, policy.maxPeriod);
+
+    std::lock_guard lock(d->mx);
+    pTask->id = d->nextTaskId++;
+    d->tasks.emplace(pTask->id, pTask);
+    d->schedule(pTask, d->tick);
+    return pTask->id;
+}
+
+bool AdaptiveScheduler::removeTask(int taskId)
+{
+    std::unique_lock lock(d->mx);
+    auto taskIt = d->tasks.find(taskId);
+    if (taskIt == d->tasks.end()) {
+        return false;
+    }
+
+    auto pTask = taskIt->second;
+    pTask->isRemoved = true;
+    d->tasks.erase(taskIt);
+    d->unschedule(pTask);
+
+    // The task's captures must stay valid until it returns, unless it removes itself
+    const bool isWheelThread = d->thread.get_id() == std::this_thread::get_id();
+    const bool isBlockingThread = d->blockingThread.get_id() == std::this_thread::get_id();
+    d->cv.wait(lock, [this, taskId, isWheelThread, isBlockingThread]() {
+        return (isWheelThread || d->runningTaskId != taskId) && (isBlockingThread || d->blockingTaskId != taskId);
+    });
+    return true;
+}
+
+void AdaptiveScheduler::requestNow(int taskId)
+{
+    std::lock_guard lock(d->mx);
+    auto taskIt = d->tasks.find(taskId);
+    if (taskIt == d->tasks.end() || d->runningTaskId == taskId || taskIt->second->isDispatched) {
+        return;
+    }
+    d->unschedule(taskIt->second);
+    d->schedule(taskIt->second, d->tick);
+}
+
+bool AdaptiveScheduler::start()
+{
+    std::lock_guard lock(d->mx);
+    if (d->thread.joinable()) {
+        return true;
+    }
+    d->stopRequested = false;
+    d->thread = std::thread([pPrivate = d.get()]() { pPrivate->run(); });
+    d->blockingThread = std::thread([pPrivate = d.get()]() { pPrivate->runBlocking(); });
+    return true;
+}
+
+void AdaptiveScheduler::stop()
+{
+    {
+        std::lock_guard lock(d->mx);
+        if (!d->thread.joinable()) {
+            return;
+        }
+        d->stopRequested = true;
+    }
+    d->cv.notify_all();
+    d->blockingCv.notify_all();
+    d->thread.join();
+    d->blockingThread.join();
+
+    // Tasks still queued for the worker go back on the wheel for the next start()
+    std::lock_guard lock(d->mx);
+    for (auto& pTask : d->blockingQueue) {
+        pTask->isDispatched = false;
+        if (!pTask->isRemoved) {
+            d->schedule(pTask, d->tick);
+        }
+    }
+    d->blockingQueue.clear();
+}
+
+bool AdaptiveScheduler::isRunning() const noexcept
+{
+    std::lock_guard lock(d->mx);
+    return d->thread.joinable() && !d->stopRequested;
+}
+
+std::chrono::milliseconds AdaptiveScheduler::currentPeriod(int taskId) const
+{
+    std::lock_guard lock(d->mx);
+    auto taskIt = d->tasks.find(taskId);
+    return taskIt != d->tasks.end() ? taskIt->second->period : std::chrono::milliseconds(0);
+}
+
+uint64_t AdaptiveScheduler::runCount(int taskId) const
+{
+    std::lock_guard lock(d->mx);
+    auto taskIt = d->tasks.find(taskId);
+    return taskIt != d->tasks.end() ? taskIt->second->runs : 0;
+}
+
+std::chrono::milliseconds AdaptiveScheduler::nextPeriod(const AdaptivePolicy &policy, std::chrono::milliseconds period,
+                                                        std::optional<double> prevValue, double value) noexcept
+{
+    // Over the threshold counts as near it: a metric stuck at 95 °C against 85 °C is not "stable"
+    if (policy.threshold.has_value() && value >= *policy.threshold - policy.thresholdMargin) {
+        return policy.minPeriod;
+    }
+    if (!prevValue.has_value()) {
+        return period;
+    }
+
+    const double delta = std::abs(value - *prevValue);
+    if (policy.volatileDelta > 0 && delta >= policy.volatileDelta) {
+        period /= 2;
+    } else if (delta < policy.stableDelta) {
+        period = period * 3 / 2;
+    }
+    return std::clamp(period, policy.minPeriod, policy.maxPeriod);
+}
+
+} // namespace SystemProcessing
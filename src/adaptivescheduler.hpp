@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The AdaptivePolicy struct    Период опроса метрики и правила его подстройки.
+ *                                     Изменения сравниваются в единицах самой метрики
+ */
+struct AdaptivePolicy
+{
+    std::chrono::milliseconds basePeriod {1000};
+    std::chrono::milliseconds minPeriod {250};
+    std::chrono::milliseconds maxPeriod {60000};
+
+    double volatileDelta {0};   // Изменение за опрос не меньше этого — период уменьшается вдвое
+    double stableDelta {0};     // Изменение меньше этого — период растёт в полтора раза
+
+    std::optional<double> threshold;    // Выше порога или ближе thresholdMargin к нему опрос идёт с minPeriod
+    double thresholdMargin {0};
+
+    bool isBlocking {false};    // Задача запускает процесс или долго ждёт: выполняется в отдельном потоке
+};
+
+/**
+ * @brief SamplingTask  Опрос метрики. Возвращает значение для подстройки периода
+ *                      или nullopt, если значение не получено (период не меняется)
+ */
+using SamplingTask = std::function<std::optional<double>()>;
+
+/**
+ * @brief The AdaptiveScheduler class  Общий планировщик опросов на колесе таймеров: у каждой метрики свой период,
+ *                                     который сокращается при резких изменениях или около порога и растёт,
+ *                                     пока значение стабильно. Задачи выполняются в потоке планировщика,
+ *                                     блокирующие (AdaptivePolicy::isBlocking) — по очереди в потоке-исполнителе,
+ *                                     чтобы не задерживать быстрые опросы
+ */
+class AdaptiveScheduler
+{
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_TICK {10};
+
+    explicit AdaptiveScheduler(std::chrono::milliseconds tick = DEFAULT_TICK);
+    ~AdaptiveScheduler();
+
+    AdaptiveScheduler(const AdaptiveScheduler&) = delete;
+    AdaptiveScheduler& operator=(const AdaptiveScheduler&) = delete;
+
+    /**
+     * @brief getInstance   Планировщик, общий для менеджеров устройств
+     */
+    static AdaptiveScheduler& getInstance();
+
+    /**
+     * @brief addTask   Добавить задачу. Первый запуск — на ближайшем тике
+     * @return  Идентификатор задачи
+     */
+    int addTask(const std::string& name, const AdaptivePolicy& policy, SamplingTask task);
+
+    /**
+     * @brief removeTask    Удалить задачу. Если она сейчас выполняется, ждёт завершения
+     *                      (кроме вызова из потока, в котором она выполняется)
+     */
+    bool removeTask(int taskId);
+
+    /**
+     * @brief requestNow    Выполнить задачу на ближайшем тике вне расписания
+     */
+    void requestNow(int taskId);
+
+    bool start();
+    void stop();
+    bool isRunning() const noexcept;
+
+    std::chrono::milliseconds currentPeriod(int taskId) const;
+    uint64_t runCount(int taskId) const;
+
+    /**
+     * @brief nextPeriod    Новый период по двум последовательным значениям метрики
+     */
+    static std::chrono::milliseconds nextPeriod(const AdaptivePolicy& policy, std::chrono::milliseconds period,
+                                                std::optional<double> prevValue, double value) noexcept;
+
+private:
+    struct SchedulerPrivate;
+    std::shared_ptr<SchedulerPrivate> d;
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,140 @@
+#include "asyncstatus.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SystemProcessing {
+
+struct LoadMeasurementScheduler::SchedulerPrivate
+{
+    struct PendingMeasurement
+    {
+        std::chrono::steady_clock::time_point deadline;
+        bool startOk {false};
+        CPUTimesTable startTimes;
+        std::vector<Completion> waiters;
+    };
+
+    ProcStatReader procStat;
+    Executor executor;
+
+    std::mutex mx;
+    std::condition_variable cv;
+    // Keyed by the window length, so equal requests share one measurement
+    std::map<std::chrono::milliseconds::rep, std::shared_ptr<PendingMeasurement>> inFlight;
+    std::thread timerThread;
+    bool stopRequested {false};
+
+    void timerLoop()
+    {
+        std::unique_lock lock(mx);
+        while (!stopRequested)
+        {
+            if (inFlight.empty()) {
+                cv.wait(lock);
+                continue;
+            }
+
+            auto nextIt = inFlight.begin();
+            for (auto it = inFlight.begin(); it != inFlight.end(); ++it) {
+                if (it->second->deadline < nextIt->second->deadline) {
+                    nextIt = it;
+                }
+            }
+
+            if (std::chrono::steady_clock::now() < nextIt->second->deadline) {
+                cv.wait_until(lock, nextIt->second->deadline);
+                continue;
+            }
+
+            auto pPending = std::move(nextIt->second);
+            inFlight.erase(nextIt);
+            const auto currentExecutor = executor;
+
+            lock.unlock();
+            complete(*pPending, currentExecutor);
+            lock.lock();
+        }
+    }
+
+    void complete(PendingMeasurement& pending, const Executor& currentExecutor)
+    {
+        auto pMeasurement = std::make_shared<LoadMeasurement>();
+
+        CPUTimesTable endTimes;
+        if (pending.startOk && procStat.read(endTimes)) {
+            pMeasurement->isValid = true;
+            pMeasurement->cpuLoad = calculateCPULoad(pending.startTimes.aggregate.idle(), pending.startTimes.aggregate.total(),
+                                                     endTimes.aggregate.idle(), endTimes.aggregate.total());
+            calculateCoresLoad(pending.startTimes, endTimes, pMeasurement->coresLoad);
+        } else {
+            COMPLOG_WARNING("Error getting CPU times");
+        }
+
+        const MeasurementPtr result = std::move(pMeasurement);
+        for (auto& waiter : pending.waiters) {
+            if (currentExecutor) {
+                currentExecutor([waiter = std::move(waiter), result]() { waiter(result); });
+            } else {
+                waiter(result);
+            }
+        }
+    }
+};
+
+LoadMeasurementScheduler::LoadMeasurementScheduler(Executor executor) :
+    d {new SchedulerPrivate}
+{
+    d->executor = std::move(executor);
+}
+
+LoadMeasurementScheduler::~LoadMeasurementScheduler()
+{
+    {
+        std::lock_guard lock(d->mx);
+        d->stopRequested = true;
+    }
+    d->cv.notify_all();
+
+    if (!d->timerThread.joinable()) {
+        return;
+    }
+    // A waiter completed on the timer thread may drop the last scheduler reference.
+    // The thread owns the private state, so it finishes the loop on its own
+    if (d->timerThread.get_id() == std::this_thread::get_id()) {
+        d->timerThread.detach();
+    } else {
+        d->timerThread.join();
+    }
+}
+
+void LoadMeasurementScheduler::setExecutor(Executor executor)
+{
+    std::lock_guard lock(d->mx);
+    d->executor = std::move(executor);
+}
+
+void LoadMeasurementScheduler::measure(std::chrono::milliseconds window, Completion completion)
+{
+    std::lock_guard lock(d->mx);
+
+    auto& pPending = d->inFlight[window.count()];
+    if (!pPending) {
+        pPending = std::make_shared<SchedulerPrivate::PendingMeasurement>();
+        pPending->startOk = d->procStat.read(pPending->startTimes);
+        pPending->deadline = std::chrono::steady_clock::now() + window;
+
+        if (!d->timerThread.joinable()) {
+            d->timerThread = std::thread([pPrivate = d]() { pPrivate->timerLoop(); });
+        }
+    }
+    pPending->waiters.push_back(std::move(completion));
+    d->cv.notify_all();
+}
+
+} // namespace SystemProcessing
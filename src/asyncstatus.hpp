@@ -0,0 +1,115 @@
+#pragma once
+
+#include "procstatreader.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SYSTEMPROCESSING_HAS_COROUTINES 1
+#else
+#define SYSTEMPROCESSING_HAS_COROUTINES 0
+#endif
+
+namespace SystemProcessing {
+
+/**
+ * @brief The LoadMeasurement struct   Результат одного замера загрузки за окно
+ */
+struct LoadMeasurement
+{
+    bool isValid {false};
+    double cpuLoad {0};         // Проценты
+    CPUCoresLoad coresLoad;     // Пусто, если набор ядер изменился за окно
+};
+
+/**
+ * @brief The LoadMeasurementScheduler class   Неблокирующие замеры загрузки: начало окна читается сразу,
+ *                                              конец — по таймеру в отдельном потоке. Одновременные запросы
+ *                                              с одинаковым окном получают результат одного замера
+ */
+class LoadMeasurementScheduler
+{
+public:
+    using MeasurementPtr = std::shared_ptr<const LoadMeasurement>;
+    using Completion = std::function<void(const MeasurementPtr& measurement)>;
+
+    // Запускает задачу в нужном потоке (например, в executor'е корутин). По умолчанию — в потоке таймера
+    using Executor = std::function<void(std::function<void()> task)>;
+
+    explicit LoadMeasurementScheduler(Executor executor = {});
+    ~LoadMeasurementScheduler();
+
+    LoadMeasurementScheduler(const LoadMeasurementScheduler&) = delete;
+    LoadMeasurementScheduler& operator=(const LoadMeasurementScheduler&) = delete;
+
+    void setExecutor(Executor executor);
+
+    /**
+     * @brief measure   Запросить замер. Если замер с таким окном уже идёт, запрос присоединяется к нему
+     * @param completion    Вызывается через Executor по окончании окна
+     */
+    void measure(std::chrono::milliseconds window, Completion completion);
+
+private:
+    struct SchedulerPrivate;
+    std::shared_ptr<SchedulerPrivate> d;
+};
+
+#if SYSTEMPROCESSING_HAS_COROUTINES
+
+/**
+ * @brief The LoadMeasurementAwaitable class   co_await замера: корутина приостанавливается до конца окна,
+ *                                              поток при этом не блокируется
+ */
+class LoadMeasurementAwaitable
+{
+public:
+    LoadMeasurementAwaitable(std::shared_ptr<LoadMeasurementScheduler> pScheduler,
+                             std::chrono::milliseconds window,
+                             LoadMeasurementScheduler::MeasurementPtr readyResult = nullptr) :
+        m_pScheduler {std::move(pScheduler)},
+        m_window {window},
+        m_result {std::move(readyResult)}
+    {
+
+    }
+
+    bool await_ready() const noexcept { return m_result != nullptr; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_pScheduler->measure(m_window, [this, handle](const LoadMeasurementScheduler::MeasurementPtr& measurement) {
+            m_result = measurement;
+            handle.resume();
+        });
+    }
+
+    LoadMeasurementScheduler::MeasurementPtr await_resume() const noexcept { return m_result; }
+
+private:
+    std::shared_ptr<LoadMeasurementScheduler> m_pScheduler;
+    std::chrono::milliseconds m_window;
+    LoadMeasurementScheduler::MeasurementPtr m_result;
+};
+
+/**
+ * @brief The CPULoadAwaitable class   co_await загрузки в процентах
+ */
+class CPULoadAwaitable : public LoadMeasurementAwaitable
+{
+public:
+    using LoadMeasurementAwaitable::LoadMeasurementAwaitable;
+
+    double await_resume() const noexcept
+    {
+        auto measurement = LoadMeasurementAwaitable::await_resume();
+        return measurement ? measurement->cpuLoad : 0;
+    }
+};
+
+#endif // SYSTEMPROCESSING_HAS_COROUTINES
+
+} // namespace SystemProcessing
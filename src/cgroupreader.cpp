@@ -0,0 +1,528 @@
+#include "cgroupreader.hpp"
+#include "dirfdbudget.hpp"
+#include "probestats.hpp"
+#include "sysutil.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+constexpr const char* CGROUP_FILE_NAMES[] {
+    "cpu.stat",
+    "cpu.max",
+    "memory.current",
+    "memory.max",
+    "memory.stat",
+    "io.stat",
+};
+
+// memory.stat is the largest file, about 1.5 KiB; io.stat grows by a line per device
+constexpr size_t READ_BUFFER_SIZE = 8192;
+
+template<typename Field>
+struct FlatKey {
+    std::string_view name;
+    uint64_t Field::* field;
+};
+
+constexpr FlatKey<CgroupCPUStats> CPU_STAT_KEYS[] {
+    {"usage_usec", &CgroupCPUStats::usageUsec},
+    {"user_usec", &CgroupCPUStats::userUsec},
+    {"system_usec", &CgroupCPUStats::systemUsec},
+    {"nr_periods", &CgroupCPUStats::periodsCount},
+    {"nr_throttled", &CgroupCPUStats::throttledCount},
+    {"throttled_usec", &CgroupCPUStats::throttledUsec},
+};
+
+constexpr FlatKey<CgroupMemoryStats> MEMORY_STAT_KEYS[] {
+    {"anon", &CgroupMemoryStats::anon},
+    {"file", &CgroupMemoryStats::file},
+    {"kernel", &CgroupMemoryStats::kernel},
+    {"shmem", &CgroupMemoryStats::shmem},
+    {"sock", &CgroupMemoryStats::sock},
+    {"file_dirty", &CgroupMemoryStats::fileDirty},
+    {"pgfault", &CgroupMemoryStats::pageFaults},
+    {"pgmajfault", &CgroupMemoryStats::majorPageFaults},
+};
+
+constexpr FlatKey<CgroupIOStats> IO_STAT_KEYS[] {
+    {"rbytes", &CgroupIOStats::readBytes},
+    {"wbytes", &CgroupIOStats::writeBytes},
+    {"rios", &CgroupIOStats::readOps},
+    {"wios", &CgroupIOStats::writeOps},
+    {"dbytes", &CgroupIOStats::discardBytes},
+    {"dios", &CgroupIOStats::discardOps},
+};
+
+std::string_view trim(std::string_view text) noexcept
+{
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool parseValue(std::string_view text, uint64_t& oValue) noexcept
+{
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), oValue);
+    return ec == std::errc();
+}
+
+/**
+ * "key value" lines of cpu.stat and memory.stat; unknown keys are skipped
+ */
+template<typename Field, size_t KeysCount>
+void parseFlatKeyed(std::string_view text, const FlatKey<Field> (&keys)[KeysCount], Field& oStats) noexcept
+{
+    size_t hint = 0;
+    while (!text.empty())
+    {
+        auto lineEnd = text.find('\n');
+        auto line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        const auto spacePos = line.find(' ');
+        if (spacePos == std::string_view::npos) {
+            continue;
+        }
+        const auto name = line.substr(0, spacePos);
+        for (size_t i = 0; i < KeysCount; ++i) {
+            const size_t pos = (hint + i) % KeysCount;
+            if (keys[pos].name == name) {
+                parseValue(line.substr(spacePos + 1), oStats.*keys[pos].field);
+                hint = pos + 1;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0" per device, summed
+ */
+void parseIOStat(std::string_view text, CgroupIOStats& oStats) noexcept
+{
+    while (!text.empty())
+    {
+        auto lineEnd = text.find('\n');
+        auto line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        auto fieldPos = line.find(' ');
+        while (fieldPos != std::string_view::npos)
+        {
+            line.remove_prefix(fieldPos + 1);
+            fieldPos = line.find(' ');
+            const auto field = line.substr(0, fieldPos);
+            const auto equalPos = field.find('=');
+            if (equalPos == std::string_view::npos) {
+                continue;
+            }
+
+            const auto name = field.substr(0, equalPos);
+            for (auto& key : IO_STAT_KEYS) {
+                uint64_t value {0};
+                if (key.name == name && parseValue(field.substr(equalPos + 1), value)) {
+                    oStats.*key.field += value;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * "max 100000" or "50000 100000"
+ */
+void parseCPUMax(std::string_view text, CgroupCPULimit& oLimit) noexcept
+{
+    const auto spacePos = text.find(' ');
+    const auto quota = text.substr(0, spacePos);
+    uint64_t value {0};
+    oLimit.quotaUsec = quota != "max" && parseValue(quota, value) ? static_cast<int64_t>(value) : -1;
+    if (spacePos != std::string_view::npos && parseValue(text.substr(spacePos + 1), value)) {
+        oLimit.periodUsec = value;
+    }
+}
+
+} // namespace
+
+CgroupReader::CgroupReader(const std::string &cgroupRoot) :
+    m_rootFd {::open(cgroupRoot.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)}
+{
+    if (m_rootFd < 0) {
+        COMPLOG_WARNING("Error opening cgroup root:", cgroupRoot);
+    }
+}
+
+CgroupReader::~CgroupReader()
+{
+    for (auto& entry : m_cgroups) {
+        closeEntry(entry);
+    }
+    if (m_rootFd >= 0) {
+        ::close(m_rootFd);
+    }
+}
+
+bool CgroupReader::isOpened() const noexcept
+{
+    if (m_rootFd < 0) {
+        return false;
+    }
+    return ::faccessat(m_rootFd, "cgroup.controllers", F_OK, 0) == 0;
+}
+
+std::string CgroupReader::defaultRoot()
+{
+    // Only the unified hierarchy has cgroup.controllers in its root
+    const auto cgroupRoot = FsRoot::path("/sys/fs/cgroup");
+    if (::access((cgroupRoot + "/cgroup.controllers").c_str(), F_OK) != 0
+            && ::access((cgroupRoot + "/unified/cgroup.controllers").c_str(), F_OK) == 0) {
+        return cgroupRoot + "/unified";
+    }
+    return cgroupRoot;
+}
+
+std::string CgroupReader::selfCgroup(const std::string &procCgroupPath)
+{
+    const int fd = ::open(procCgroupPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
+    }
+    char buffer[READ_BUFFER_SIZE];
+    const auto readBytes = ::read(fd, buffer, sizeof(buffer));
+    ::close(fd);
+    if (readBytes <= 0) {
+        return {};
+    }
+
+    // The unified hierarchy is the "0::/path" line; v1 controllers have their own lines
+    std::string_view text(buffer, readBytes);
+    while (!text.empty())
+    {
+        auto lineEnd = text.find('\n');
+        auto line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        if (line.substr(0, 3) == "0::") {
+            return std::string(line.substr(3));
+        }
+    }
+    return {};
+}
+
+int CgroupReader::add(const std::string &cgroupPath)
+{
+    return openEntry(cgroupPath, true);
+}
+
+int CgroupReader::addSelf()
+{
+    const auto cgroupPath = selfCgroup();
+    if (cgroupPath.empty()) {
+        COMPLOG_WARNING("Process is not in a cgroup v2 hierarchy");
+        return INVALID_INDEX;
+    }
+    return add(cgroupPath);
+}
+
+size_t CgroupReader::size() const noexcept
+{
+    return m_cgroups.size();
+}
+
+bool CgroupReader::isValid(int index) const noexcept
+{
+    return index >= 0 && static_cast<size_t>(index) < m_cgroups.size() && m_cgroups[index].isOpened;
+}
+
+const std::string &CgroupReader::path(int index) const
+{
+    return m_cgroups.at(index).path;
+}
+
+bool CgroupReader::scan(size_t maxDirectories)
+{
+    if (m_rootFd < 0) {
+        return true;
+    }
+
+    if (m_scanQueue.empty()) {
+        ++m_scanPass;
+        const int rootIndex = openEntry("/", false);
+        if (rootIndex == INVALID_INDEX) {
+            return true;
+        }
+        m_cgroups[rootIndex].scanPass = m_scanPass;
+        m_scanQueue.push_back(rootIndex);
+    }
+
+    for (size_t processed = 0; processed < maxDirectories && !m_scanQueue.empty(); ++processed)
+    {
+        const int index = m_scanQueue.back();
+        m_scanQueue.pop_back();
+        if (!isValid(index)) {
+            continue;
+        }
+
+        // fdopendir takes ownership of the descriptor, the cached one stays open
+        const int listFd = openAt(m_cgroups[index], ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        DIR* pDir = listFd >= 0 ? ::fdopendir(listFd) : nullptr;
+        if (pDir == nullptr) {
+            if (listFd >= 0) {
+                ::close(listFd);
+            }
+            continue;
+        }
+
+        const std::string parentPath = m_cgroups[index].path == "/" ? std::string() : m_cgroups[index].path;
+        while (auto pEntry = ::readdir(pDir))
+        {
+            if (pEntry->d_type != DT_DIR || pEntry->d_name[0] == '.') {
+                continue;
+            }
+            const int childIndex = openEntry(parentPath + "/" + pEntry->d_name, false);
+            if (childIndex != INVALID_INDEX) {
+                m_cgroups[childIndex].scanPass = m_scanPass;
+                m_scanQueue.push_back(childIndex);
+            }
+        }
+        ::closedir(pDir);
+    }
+
+    if (!m_scanQueue.empty()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_cgroups.size(); ++i) {
+        auto& entry = m_cgroups[i];
+        if (entry.isOpened && !entry.isPinned && entry.scanPass != m_scanPass) {
+            m_indexes.erase(entry.path);
+            closeEntry(entry);
+            m_freeIndexes.push_back(static_cast<int>(i));
+        }
+    }
+    return true;
+}
+
+bool CgroupReader::read(int index, CgroupStats &oStats) const
+{
+    if (!isValid(index)) {
+        return false;
+    }
+    const auto& entry = m_cgroups[index];
+
+    char buffer[READ_BUFFER_SIZE];
+    SYSTEMPROCESSING_PROBE(probe, "cgroup.read");
+
+    // cpu.stat exists in every group, whichever controllers are enabled
+    auto readBytes = readFile(entry, CPUStat, buffer, sizeof(buffer));
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+    probe.addBytes(readBytes);
+    oStats = {};
+    oStats.timestampNs = monotonicNs();
+    parseFlatKeyed(std::string_view(buffer, readBytes), CPU_STAT_KEYS, oStats.cpu);
+
+    readBytes = readFile(entry, CPUMax, buffer, sizeof(buffer));
+    if (readBytes > 0) {
+        probe.addBytes(readBytes);
+        parseCPUMax(trim(std::string_view(buffer, readBytes)), oStats.cpuLimit);
+    }
+
+    readBytes = readFile(entry, MemoryCurrent, buffer, sizeof(buffer));
+    if (readBytes > 0) {
+        probe.addBytes(readBytes);
+        oStats.hasMemory = parseValue(trim(std::string_view(buffer, readBytes)), oStats.memory.current);
+
+        readBytes = readFile(entry, MemoryMax, buffer, sizeof(buffer));
+        if (readBytes > 0) {
+            probe.addBytes(readBytes);
+            if (!parseValue(trim(std::string_view(buffer, readBytes)), oStats.memory.max)) {
+                oStats.memory.max = CgroupMemoryStats::UNLIMITED;
+            }
+        }
+
+        readBytes = readFile(entry, MemoryStat, buffer, sizeof(buffer));
+        if (readBytes > 0) {
+            probe.addBytes(readBytes);
+            parseFlatKeyed(std::string_view(buffer, readBytes), MEMORY_STAT_KEYS, oStats.memory);
+        }
+    }
+
+    readBytes = readFile(entry, IOStat, buffer, sizeof(buffer));
+    if (readBytes >= 0) {
+        probe.addBytes(readBytes);
+        oStats.hasIO = true;
+        parseIOStat(std::string_view(buffer, readBytes), oStats.io);
+    }
+    return true;
+}
+
+double CgroupReader::cpuLoad(const CgroupStats &prev, const CgroupStats &cur) noexcept
+{
+    if (cur.timestampNs <= prev.timestampNs || cur.cpu.usageUsec < prev.cpu.usageUsec) {
+        return 0;
+    }
+
+    double cores = availableCPUs();
+    if (cur.cpuLimit.isLimited()) {
+        cores = std::min(cores, cur.cpuLimit.cores());
+    }
+    if (cores <= 0) {
+        return 0;
+    }
+
+    const double elapsedUsec = (cur.timestampNs - prev.timestampNs) / 1000.0;
+    const double load = (cur.cpu.usageUsec - prev.cpu.usageUsec) / (elapsedUsec * cores) * 100.0;
+    return std::min(load, 100.0);
+}
+
+unsigned CgroupReader::availableCPUs() noexcept
+{
+    cpu_set_t cpuSet;
+    if (::sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        return CPU_COUNT(&cpuSet);
+    }
+    const auto onlineCount = ::sysconf(_SC_NPROCESSORS_ONLN);
+    return onlineCount > 0 ? static_cast<unsigned>(onlineCount) : 1;
+}
+
+int CgroupReader::openEntry(const std::string &cgroupPath, bool isPinned)
+{
+    std::string normalizedPath = cgroupPath.empty() || cgroupPath.front() != '/' ? "/" + cgroupPath : cgroupPath;
+    while (normalizedPath.size() > 1 && normalizedPath.back() == '/') {
+        normalizedPath.pop_back();
+    }
+
+    auto indexIt = m_indexes.find(normalizedPath);
+    if (indexIt != m_indexes.end()) {
+        auto& entry = m_cgroups[indexIt->second];
+        if (isPinned && !entry.isPinned) {
+            // Pinned groups always keep their directory and are not counted in the budget
+            if (entry.dirFd >= 0) {
+                DirFdBudget::release();
+            } else {
+                entry.dirFd = openAt(entry, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            }
+            entry.isPinned = true;
+        }
+        return indexIt->second;
+    }
+    if (m_rootFd < 0) {
+        return INVALID_INDEX;
+    }
+
+    const char* relativePath = normalizedPath == "/" ? "." : normalizedPath.c_str() + 1;
+    int dirFd = ::openat(m_rootFd, relativePath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        if (isPinned) {
+            COMPLOG_WARNING("Error opening cgroup:", normalizedPath);
+        }
+        return INVALID_INDEX;
+    }
+    // Scanned groups can number in thousands: past the budget they are opened by path
+    if (!isPinned && !DirFdBudget::tryAcquire()) {
+        ::close(dirFd);
+        dirFd = -1;
+    }
+
+    int index;
+    if (!m_freeIndexes.empty()) {
+        index = m_freeIndexes.back();
+        m_freeIndexes.pop_back();
+    } else {
+        index = static_cast<int>(m_cgroups.size());
+        m_cgroups.emplace_back();
+    }
+
+    auto& entry = m_cgroups[index];
+    entry.path = std::move(normalizedPath);
+    entry.dirFd = dirFd;
+    entry.fds.fill(-1);
+    entry.isOpened = true;
+    entry.isPinned = isPinned;
+    entry.scanPass = 0;
+    m_indexes.emplace(entry.path, index);
+    return index;
+}
+
+void CgroupReader::closeEntry(CgroupEntry &entry) noexcept
+{
+    for (auto& fd : entry.fds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (entry.dirFd >= 0) {
+        ::close(entry.dirFd);
+        if (!entry.isPinned) {
+            DirFdBudget::release();
+        }
+        entry.dirFd = -1;
+    }
+    entry.isOpened = false;
+}
+
+int CgroupReader::openAt(const CgroupEntry &entry, const char *name, int flags) const noexcept
+{
+    if (entry.dirFd >= 0) {
+        return ::openat(entry.dirFd, name, flags);
+    }
+
+    // Relative to the root, as the group path without its leading slash
+    char path[PATH_MAX];
+    const int pathSize = entry.path == "/"
+            ? std::snprintf(path, sizeof(path), "%s", name)
+            : std::snprintf(path, sizeof(path), "%s/%s", entry.path.c_str() + 1, name);
+    if (pathSize < 0 || static_cast<size_t>(pathSize) >= sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return ::openat(m_rootFd, path, flags);
+}
+
+ssize_t CgroupReader::readFile(const CgroupEntry &entry, CgroupFile file, char *buffer, size_t bufferSize) const
+{
+    // Scanned groups can number in thousands: their files are opened per read, see DirFdBudget
+    if (!entry.isPinned) {
+        const int fd = openAt(entry, CGROUP_FILE_NAMES[file], O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return -1;
+        }
+        const auto readBytes = ::pread(fd, buffer, bufferSize, 0);
+        ::close(fd);
+        return readBytes;
+    }
+
+    auto& fd = entry.fds[file];
+    if (fd < 0) {
+        fd = openAt(entry, CGROUP_FILE_NAMES[file], O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return -1;
+        }
+    }
+    return ::pread(fd, buffer, bufferSize, 0);
+}
+
+} // namespace SystemProcessing
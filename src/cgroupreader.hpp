@@ -0,0 +1,202 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The CgroupCPUStats struct    Счётчики cpu.stat в микросекундах
+ */
+struct CgroupCPUStats
+{
+    uint64_t usageUsec {0};
+    uint64_t userUsec {0};
+    uint64_t systemUsec {0};
+    uint64_t periodsCount {0};
+    uint64_t throttledCount {0};        // Периоды, в которых группа упёрлась в квоту
+    uint64_t throttledUsec {0};
+};
+
+/**
+ * @brief The CgroupCPULimit struct    Квота из cpu.max
+ */
+struct CgroupCPULimit
+{
+    int64_t quotaUsec {-1};             // -1 — без ограничения ("max")
+    uint64_t periodUsec {100000};
+
+    bool isLimited() const noexcept { return quotaUsec >= 0 && periodUsec != 0; }
+
+    /**
+     * @brief cores Квота в ядрах (1.5 — полтора ядра), 0 без ограничения
+     */
+    double cores() const noexcept { return isLimited() ? double(quotaUsec) / periodUsec : 0; }
+};
+
+/**
+ * @brief The CgroupMemoryStats struct Память группы из memory.current, memory.max и memory.stat. Размеры в байтах
+ */
+struct CgroupMemoryStats
+{
+    static constexpr uint64_t UNLIMITED = UINT64_MAX;
+
+    uint64_t current {0};
+    uint64_t max {UNLIMITED};
+    uint64_t anon {0};
+    uint64_t file {0};
+    uint64_t kernel {0};
+    uint64_t shmem {0};
+    uint64_t sock {0};
+    uint64_t fileDirty {0};
+    uint64_t pageFaults {0};
+    uint64_t majorPageFaults {0};
+};
+
+/**
+ * @brief The CgroupIOStats struct Счётчики io.stat, суммированные по всем устройствам
+ */
+struct CgroupIOStats
+{
+    uint64_t readBytes {0};
+    uint64_t writeBytes {0};
+    uint64_t readOps {0};
+    uint64_t writeOps {0};
+    uint64_t discardBytes {0};
+    uint64_t discardOps {0};
+};
+
+/**
+ * @brief The CgroupStats struct   Снимок одной группы. Файлы выключенных контроллеров пропускаются,
+ *                                 соответствующие поля остаются по умолчанию
+ */
+struct CgroupStats
+{
+    uint64_t timestampNs {0};           // CLOCK_MONOTONIC момента чтения cpu.stat
+
+    CgroupCPUStats cpu;
+    CgroupCPULimit cpuLimit;
+    CgroupMemoryStats memory;
+    CgroupIOStats io;
+
+    bool hasMemory {false};
+    bool hasIO {false};
+};
+
+/**
+ * @brief The CgroupReader class   Чтение групп cgroup v2. Каталог каждой группы открыт всё время жизни объекта,
+ *                                 файлы открываются через openat относительно него. Иерархию можно обходить
+ *                                 частями (scan), чтобы не останавливаться надолго на тысячах групп
+ */
+class CgroupReader
+{
+public:
+    static constexpr int INVALID_INDEX = -1;
+
+    explicit CgroupReader(const std::string& cgroupRoot = defaultRoot());
+    ~CgroupReader();
+
+    CgroupReader(const CgroupReader&) = delete;
+    CgroupReader& operator=(const CgroupReader&) = delete;
+
+    /**
+     * @brief isOpened  Корень смонтирован как cgroup v2
+     */
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief defaultRoot   /sys/fs/cgroup или /sys/fs/cgroup/unified в гибридном режиме (v1 и v2 одновременно)
+     */
+    static std::string defaultRoot();
+
+    /**
+     * @brief selfCgroup    Путь группы текущего процесса ("/system.slice/agent.service") из /proc/self/cgroup
+     * @return  Пустая строка, если процесс не в иерархии cgroup v2
+     */
+    static std::string selfCgroup(const std::string& procCgroupPath = FsRoot::path("/proc/self/cgroup"));
+
+    /**
+     * @brief add   Добавить группу по пути относительно корня. Файлы такой группы остаются открытыми,
+     *              scan её не удаляет
+     * @return  Индекс группы или INVALID_INDEX, если каталог не открылся
+     */
+    int add(const std::string& cgroupPath);
+
+    /**
+     * @brief addSelf   Добавить группу текущего процесса
+     */
+    int addSelf();
+
+    size_t size() const noexcept;
+    bool isValid(int index) const noexcept;
+    const std::string& path(int index) const;
+
+    /**
+     * @brief scan  Продолжить обход иерархии: обработать не больше maxDirectories каталогов.
+     *              Найденные группы добавляются, исчезнувшие закрываются по завершении прохода,
+     *              а их индексы могут достаться новым группам
+     * @return  true, если проход завершён. Следующий вызов начинает новый проход
+     */
+    bool scan(size_t maxDirectories = 256);
+
+    /**
+     * @brief read  Прочитать группу
+     * @return  false, если группа удалена или cpu.stat не читается
+     */
+    bool read(int index, CgroupStats& oStats) const;
+
+    /**
+     * @brief cpuLoad   Загруженность группы между двумя снимками в процентах от доступного ей времени:
+     *                  квоты cpu.max, а без неё — числа процессоров, на которых может работать процесс
+     */
+    static double cpuLoad(const CgroupStats& prev, const CgroupStats& cur) noexcept;
+
+    /**
+     * @brief availableCPUs Число процессоров в маске sched_getaffinity текущего процесса (учитывает cpuset)
+     */
+    static unsigned availableCPUs() noexcept;
+
+private:
+    enum CgroupFile : uint8_t {
+        CPUStat,
+        CPUMax,
+        MemoryCurrent,
+        MemoryMax,
+        MemoryStat,
+        IOStat,
+        FilesCount
+    };
+
+    struct CgroupEntry {
+        std::string path;
+        int dirFd {-1};                             // У найденных scan — только в пределах DirFdBudget
+        mutable std::array<int, FilesCount> fds;    // Только для групп, добавленных через add
+        bool isOpened {false};
+        bool isPinned {false};
+        uint64_t scanPass {0};
+    };
+
+    int m_rootFd {-1};
+    std::vector<CgroupEntry> m_cgroups;
+    std::unordered_map<std::string, int> m_indexes;
+    std::vector<int> m_freeIndexes;
+
+    // Directories of the current scan pass still to be listed
+    std::vector<int> m_scanQueue;
+    uint64_t m_scanPass {0};
+
+    int openEntry(const std::string& cgroupPath, bool isPinned);
+    void closeEntry(CgroupEntry& entry) noexcept;
+    int openAt(const CgroupEntry& entry, const char* name, int flags) const noexcept;
+    ssize_t readFile(const CgroupEntry& entry, CgroupFile file, char* buffer, size_t bufferSize) const;
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,27 @@
+#pragma once
+
+// Collectors built into the component; set by the SYSTEMPROCESSING_WITH_* CMake options
+#ifndef SYSTEMPROCESSING_WITH_HWMON
+#define SYSTEMPROCESSING_WITH_HWMON 1
+#endif
+#ifndef SYSTEMPROCESSING_WITH_PSI
+#define SYSTEMPROCESSING_WITH_PSI 1
+#endif
+#ifndef SYSTEMPROCESSING_WITH_AMDGPU
+#define SYSTEMPROCESSING_WITH_AMDGPU 1
+#endif
+#ifndef SYSTEMPROCESSING_WITH_NVIDIA
+#define SYSTEMPROCESSING_WITH_NVIDIA 0
+#endif
+#ifndef SYSTEMPROCESSING_WITH_NETWORK
+#define SYSTEMPROCESSING_WITH_NETWORK 1
+#endif
+#ifndef SYSTEMPROCESSING_WITH_DISKS
+#define SYSTEMPROCESSING_WITH_DISKS 1
+#endif
+#ifndef SYSTEMPROCESSING_WITH_PERF
+#define SYSTEMPROCESSING_WITH_PERF 1
+#endif
+#ifndef SYSTEMPROCESSING_WITH_RAPL
+#define SYSTEMPROCESSING_WITH_RAPL 1
+#endif
@@ -0,0 +1,178 @@
+#include "cpufreqreader.hpp"
+#include "probestats.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <numeric>
+#include <string_view>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// scaling_cur_freq is a kHz number and a newline
+constexpr size_t FREQUENCY_SLOT_CAPACITY = 32;
+
+// /proc/cpuinfo takes about 1.5 KiB per logical CPU
+constexpr size_t CPUINFO_INITIAL_SIZE = 65536;
+
+void updateSummary(CPUFrequencies& oFrequencies) noexcept
+{
+    if (oFrequencies.currentMHz.empty()) {
+        oFrequencies.minMHz = oFrequencies.avgMHz = oFrequencies.maxMHz = 0;
+        return;
+    }
+    auto [minIt, maxIt] = std::minmax_element(oFrequencies.currentMHz.begin(), oFrequencies.currentMHz.end());
+    oFrequencies.minMHz = *minIt;
+    oFrequencies.maxMHz = *maxIt;
+    oFrequencies.avgMHz = std::accumulate(oFrequencies.currentMHz.begin(), oFrequencies.currentMHz.end(), 0.0)
+            / oFrequencies.currentMHz.size();
+}
+
+} // namespace
+
+CpufreqReader::CpufreqReader(const std::string &cpuRoot, const std::string &cpuinfoPath)
+{
+    std::vector<uint32_t> coreIds;
+    if (auto pDir = ::opendir(cpuRoot.c_str()))
+    {
+        while (auto pEntry = ::readdir(pDir))
+        {
+            if (std::strncmp(pEntry->d_name, "cpu", 3) != 0) {
+                continue;
+            }
+            uint32_t coreId {0};
+            auto [ptr, ec] = std::from_chars(pEntry->d_name + 3, pEntry->d_name + std::strlen(pEntry->d_name), coreId);
+            if (ec == std::errc() && *ptr == '\0') {
+                coreIds.push_back(coreId);
+            }
+        }
+        ::closedir(pDir);
+    }
+    std::sort(coreIds.begin(), coreIds.end());
+
+    // Offline cores have no cpufreq directory and are skipped
+    for (auto coreId : coreIds) {
+        const auto slot = m_batch.add(cpuRoot + "/cpu" + std::to_string(coreId) + "/cpufreq/scaling_cur_freq",
+                                      FREQUENCY_SLOT_CAPACITY);
+        if (slot != SysfsBatchReader::INVALID_SLOT) {
+            m_coreIds.push_back(coreId);
+        }
+    }
+
+    if (m_coreIds.empty()) {
+        m_cpuinfoFd = ::open(cpuinfoPath.c_str(), O_RDONLY | O_CLOEXEC);
+        m_cpuinfoBuffer.resize(CPUINFO_INITIAL_SIZE);
+    }
+}
+
+CpufreqReader::~CpufreqReader()
+{
+    if (m_cpuinfoFd >= 0) {
+        ::close(m_cpuinfoFd);
+    }
+}
+
+bool CpufreqReader::isOpened() const noexcept
+{
+    return !m_coreIds.empty() || m_cpuinfoFd >= 0;
+}
+
+bool CpufreqReader::isUsingCpufreq() const noexcept
+{
+    return !m_coreIds.empty();
+}
+
+bool CpufreqReader::read(CPUFrequencies &oFrequencies)
+{
+    if (m_coreIds.empty()) {
+        return readCpuinfo(oFrequencies);
+    }
+
+    SYSTEMPROCESSING_PROBE(probe, "cpufreq.read");
+    m_batch.readAll();
+
+    oFrequencies.coreIds.clear();
+    oFrequencies.currentMHz.clear();
+    for (size_t slot = 0; slot < m_coreIds.size(); ++slot) {
+        int64_t frequencyKHz {0};
+        if (m_batch.value(slot, frequencyKHz)) {
+            oFrequencies.coreIds.push_back(m_coreIds[slot]);
+            oFrequencies.currentMHz.push_back(frequencyKHz / 1000.0);
+        }
+    }
+    updateSummary(oFrequencies);
+    if (oFrequencies.coreIds.empty()) {
+        probe.fail();
+        return false;
+    }
+    return true;
+}
+
+bool CpufreqReader::readCpuinfo(CPUFrequencies &oFrequencies)
+{
+    if (m_cpuinfoFd < 0) {
+        return false;
+    }
+
+    SYSTEMPROCESSING_PROBE(probe, "cpufreq.cpuinfo.read");
+    size_t readTotal = 0;
+    while (true)
+    {
+        const auto readBytes = ::pread(m_cpuinfoFd, m_cpuinfoBuffer.data() + readTotal,
+                                       m_cpuinfoBuffer.size() - readTotal, readTotal);
+        if (readBytes < 0) {
+            probe.fail();
+            return false;
+        }
+        if (readBytes == 0) {
+            break;
+        }
+        readTotal += readBytes;
+        if (readTotal == m_cpuinfoBuffer.size()) {
+            m_cpuinfoBuffer.resize(m_cpuinfoBuffer.size() * 2);
+        }
+    }
+    probe.addBytes(readTotal);
+
+    // "processor\t: 3" starts a block, "cpu MHz\t\t: 3600.000" follows in it
+    oFrequencies.coreIds.clear();
+    oFrequencies.currentMHz.clear();
+    uint32_t coreId {0};
+    std::string_view text(m_cpuinfoBuffer.data(), readTotal);
+    while (!text.empty())
+    {
+        auto lineEnd = text.find('\n');
+        auto line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        const auto colonPos = line.find(':');
+        if (colonPos == std::string_view::npos || colonPos + 2 > line.size()) {
+            continue;
+        }
+        const auto value = line.substr(colonPos + 2);
+        if (line.substr(0, 9) == "processor") {
+            std::from_chars(value.data(), value.data() + value.size(), coreId);
+        } else if (line.substr(0, 7) == "cpu MHz") {
+            double frequencyMHz {0};
+            if (std::from_chars(value.data(), value.data() + value.size(), frequencyMHz).ec == std::errc()) {
+                oFrequencies.coreIds.push_back(coreId);
+                oFrequencies.currentMHz.push_back(frequencyMHz);
+            }
+        }
+    }
+    updateSummary(oFrequencies);
+    if (oFrequencies.coreIds.empty()) {
+        probe.fail();
+        return false;
+    }
+    return true;
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "fsroot.hpp"
+#include "sysfsbatchreader.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The CPUFrequencies struct   Текущие частоты ядер в МГц. Индекс в currentMHz соответствует индексу в coreIds
+ */
+struct CPUFrequencies
+{
+    std::vector<uint32_t> coreIds;
+    std::vector<double> currentMHz;
+
+    double minMHz {0};
+    double avgMHz {0};
+    double maxMHz {0};
+
+    size_t coreCount() const noexcept { return coreIds.size(); }
+};
+
+/**
+ * @brief The CpufreqReader class  Частоты ядер из cpuN/cpufreq/scaling_cur_freq. Файлы открыты всё время жизни объекта
+ *                                 и перечитываются одним пакетом SysfsBatchReader. Без cpufreq (виртуальные машины)
+ *                                 частоты берутся из строк "cpu MHz" файла /proc/cpuinfo
+ */
+class CpufreqReader
+{
+public:
+    explicit CpufreqReader(const std::string& cpuRoot = FsRoot::path("/sys/devices/system/cpu"),
+                           const std::string& cpuinfoPath = FsRoot::path("/proc/cpuinfo"));
+    ~CpufreqReader();
+
+    CpufreqReader(const CpufreqReader&) = delete;
+    CpufreqReader& operator=(const CpufreqReader&) = delete;
+
+    /**
+     * @brief isOpened  Есть cpufreq хотя бы у одного ядра или открыт /proc/cpuinfo
+     */
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief isUsingCpufreq    Частоты читаются из cpufreq, а не из /proc/cpuinfo
+     */
+    bool isUsingCpufreq() const noexcept;
+
+    /**
+     * @brief read  Прочитать частоты всех ядер и посчитать min/avg/max
+     * @param oFrequencies  Результат. Переиспользуется между вызовами, чтобы не выделять память
+     * @return  false, если не прочитано ни одно ядро
+     */
+    bool read(CPUFrequencies& oFrequencies);
+
+private:
+    SysfsBatchReader m_batch;
+    std::vector<uint32_t> m_coreIds;    // По слотам m_batch
+
+    int m_cpuinfoFd {-1};
+    std::vector<char> m_cpuinfoBuffer;
+
+    bool readCpuinfo(CPUFrequencies& oFrequencies);
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,58 @@
+#include "dirfdbudget.hpp"
+
+#include <atomic>
+#include <limits>
+
+#include <sys/resource.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Used when the limit can't be read: half of the usual 1024 soft limit
+constexpr size_t DEFAULT_LIMIT = 512;
+
+std::atomic<size_t> s_acquired {0};
+
+size_t readLimit() noexcept
+{
+    rlimit fileLimit;
+    if (::getrlimit(RLIMIT_NOFILE, &fileLimit) != 0) {
+        return DEFAULT_LIMIT;
+    }
+    if (fileLimit.rlim_cur == RLIM_INFINITY) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return static_cast<size_t>(fileLimit.rlim_cur / 2);
+}
+
+} // namespace
+
+bool DirFdBudget::tryAcquire() noexcept
+{
+    if (s_acquired.fetch_add(1, std::memory_order_relaxed) >= limit()) {
+        s_acquired.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void DirFdBudget::release() noexcept
+{
+    s_acquired.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t DirFdBudget::limit() noexcept
+{
+    // Read once: the soft limit is normally set at startup
+    static const size_t s_limit = readLimit();
+    return s_limit;
+}
+
+size_t DirFdBudget::acquired() noexcept
+{
+    return s_acquired.load(std::memory_order_relaxed);
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The DirFdBudget class    Общий на процесс лимит дескрипторов каталогов, которые читатели (ProcessTable,
+ *                                 CgroupReader) держат открытыми между чтениями: половина мягкого RLIMIT_NOFILE.
+ *                                 Сверх лимита читатели открывают файлы по пути, остальное остаётся приложению
+ */
+class DirFdBudget
+{
+public:
+    /**
+     * @brief tryAcquire    Занять место под один дескриптор
+     * @return  false, если лимит исчерпан
+     */
+    static bool tryAcquire() noexcept;
+    static void release() noexcept;
+
+    static size_t limit() noexcept;
+    static size_t acquired() noexcept;
+};
+
+} // namespace SystemProcessing
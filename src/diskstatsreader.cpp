@@ -0,0 +1,147 @@
+#include "diskstatsreader.hpp"
+#include "probestats.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// About 100-150 bytes per device; hosts with many partitions and dm devices need more than a page
+constexpr size_t READ_BUFFER_SIZE = 65536;
+
+constexpr std::string_view VIRTUAL_DEVICE_PREFIXES[] {
+    "loop",
+    "ram",
+    "zram",
+};
+
+bool isVirtualDevice(std::string_view name) noexcept
+{
+    for (auto prefix : VIRTUAL_DEVICE_PREFIXES) {
+        if (name.substr(0, prefix.size()) == prefix) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* skipSpaces(const char* pos, const char* end) noexcept
+{
+    while (pos < end && *pos == ' ') {
+        ++pos;
+    }
+    return pos;
+}
+
+template<typename Number>
+const char* parseNumber(const char* pos, const char* end, Number& oValue) noexcept
+{
+    pos = skipSpaces(pos, end);
+    auto [ptr, ec] = std::from_chars(pos, end, oValue);
+    return ec == std::errc() ? ptr : nullptr;
+}
+
+} // namespace
+
+DiskStatsReader::DiskStatsReader(const std::string &diskStatsPath) :
+    m_fd {::open(diskStatsPath.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+
+}
+
+DiskStatsReader::~DiskStatsReader()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool DiskStatsReader::isOpened() const noexcept
+{
+    return m_fd >= 0;
+}
+
+bool DiskStatsReader::read(std::vector<DiskStats> &oDisks, bool skipVirtual) const
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    char buffer[READ_BUFFER_SIZE];
+    SYSTEMPROCESSING_PROBE(probe, "diskstats.read");
+    const auto readBytes = ::pread(m_fd, buffer, sizeof(buffer), 0);
+    probe.addBytes(readBytes);
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+
+    size_t count = 0;
+    const char* pos = buffer;
+    const char* const end = buffer + readBytes;
+    while (pos < end)
+    {
+        auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        // "   8       0 sda 1234 56 ..." — major, minor, name and then the counters
+        DiskStats stats;
+        const char* valuePos = parseNumber(pos, lineEnd, stats.major);
+        if (valuePos != nullptr) {
+            valuePos = parseNumber(valuePos, lineEnd, stats.minor);
+        }
+        if (valuePos == nullptr) {
+            pos = lineEnd + 1;
+            continue;
+        }
+
+        valuePos = skipSpaces(valuePos, lineEnd);
+        auto nameEnd = static_cast<const char*>(std::memchr(valuePos, ' ', lineEnd - valuePos));
+        if (nameEnd == nullptr) {
+            pos = lineEnd + 1;
+            continue;
+        }
+        const std::string_view name(valuePos, nameEnd - valuePos);
+        if (skipVirtual && isVirtualDevice(name)) {
+            pos = lineEnd + 1;
+            continue;
+        }
+
+        uint64_t mergedReads {}, mergedWrites {};
+        uint64_t* const fields[] {
+            &stats.readsCompleted, &mergedReads, &stats.sectorsRead, &stats.readTimeMs,
+            &stats.writesCompleted, &mergedWrites, &stats.sectorsWritten, &stats.writeTimeMs,
+            &stats.ioInProgress, &stats.ioTimeMs,
+        };
+        valuePos = nameEnd;
+        for (auto pField : fields) {
+            valuePos = parseNumber(valuePos, lineEnd, *pField);
+            if (valuePos == nullptr) {
+                break;
+            }
+        }
+
+        if (count == oDisks.size()) {
+            oDisks.emplace_back();
+        }
+        auto& rDisk = oDisks[count++];
+        stats.name = std::move(rDisk.name);
+        stats.name.assign(name.data(), name.size());
+        rDisk = std::move(stats);
+
+        pos = lineEnd + 1;
+    }
+    oDisks.resize(count);
+    return true;
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The DiskStats struct Счётчики блочного устройства из /proc/diskstats
+ */
+struct DiskStats
+{
+    std::string name;
+    uint32_t major {0};
+    uint32_t minor {0};
+    uint64_t readsCompleted {0};
+    uint64_t sectorsRead {0};       // Сектора по 512 байт независимо от устройства
+    uint64_t readTimeMs {0};
+    uint64_t writesCompleted {0};
+    uint64_t sectorsWritten {0};
+    uint64_t writeTimeMs {0};
+    uint64_t ioInProgress {0};
+    uint64_t ioTimeMs {0};          // Время, когда устройство было занято
+};
+
+/**
+ * @brief The DiskStatsReader class    Читатель /proc/diskstats: файл открыт всё время жизни объекта,
+ *                                     перечитывается через pread. Память выделяется только при росте числа устройств
+ */
+class DiskStatsReader
+{
+public:
+    explicit DiskStatsReader(const std::string& diskStatsPath = FsRoot::path("/proc/diskstats"));
+    ~DiskStatsReader();
+
+    DiskStatsReader(const DiskStatsReader&) = delete;
+    DiskStatsReader& operator=(const DiskStatsReader&) = delete;
+
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief read  Прочитать счётчики устройств
+     * @param skipVirtual   Не включать loop, ram и zram
+     * @return  false при ошибке чтения
+     */
+    bool read(std::vector<DiskStats>& oDisks, bool skipVirtual = true) const;
+
+private:
+    int m_fd {-1};
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,41 @@
+#include "fsroot.hpp"
+
+#include <mutex>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+std::mutex g_rootMx;
+std::string g_root;
+
+} // namespace
+
+void FsRoot::set(const std::string &root)
+{
+    std::string_view rootView = root;
+    while (!rootView.empty() && rootView.back() == '/') {
+        rootView.remove_suffix(1);
+    }
+
+    std::lock_guard lock(g_rootMx);
+    g_root = rootView;
+}
+
+std::string FsRoot::get()
+{
+    std::lock_guard lock(g_rootMx);
+    return g_root;
+}
+
+std::string FsRoot::path(std::string_view absolutePath)
+{
+    std::lock_guard lock(g_rootMx);
+    std::string result;
+    result.reserve(g_root.size() + absolutePath.size());
+    result.append(g_root).append(absolutePath);
+    return result;
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The FsRoot class  Корень, от которого читатели берут пути /proc и /sys по умолчанию.
+ *                          Пустой корень — настоящая файловая система. Корень задаётся до создания читателей:
+ *                          открытые ими файлы при смене корня не переоткрываются
+ */
+class FsRoot
+{
+public:
+    FsRoot() = delete;
+
+    /**
+     * @brief set   Задать корень, например каталог SysfsReplayer::root(). "" или "/" — вернуть настоящую ФС
+     */
+    static void set(const std::string& root);
+
+    static std::string get();
+
+    /**
+     * @brief path  Абсолютный путь ("/proc/stat") относительно текущего корня
+     */
+    static std::string path(std::string_view absolutePath);
+};
+
+} // namespace SystemProcessing
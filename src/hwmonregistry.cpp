@@ -0,0 +1,278 @@
+#include "hwmonregistry.hpp"
+#include "probestats.hpp"
+
+#include <Components/Logger/Logger.h>
+#include <Components/Filework/Common.h>
+
+#include <algorithm>
+#include <charconv>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Ordered by priority: the first chip found is used as the CPU temperature source
+constexpr std::string_view CPU_TEMPERATURE_CHIPS[] {
+    "k10temp",
+    "coretemp",
+    "zenpower",
+    "cpu_thermal",
+    "soc_thermal",
+};
+
+struct SensorPrefix {
+    std::string_view prefix;
+    SensorType type;
+    double scale;
+};
+
+// Units of the kernel hwmon ABI: millidegree Celsius, RPM and microwatt
+constexpr SensorPrefix SENSOR_PREFIXES[] {
+    {"temp", SensorType::Temperature, 1e-3},
+    {"fan", SensorType::Fan, 1.0},
+    {"power", SensorType::Power, 1e-6},
+};
+
+const SensorPrefix* prefixForType(SensorType type) noexcept
+{
+    for (auto& prefix : SENSOR_PREFIXES) {
+        if (prefix.type == type) {
+            return &prefix;
+        }
+    }
+    return nullptr;
+}
+
+std::string trimmed(std::string value)
+{
+    while (!value.empty() && (value.back() == '\n' || value.back() == ' ')) {
+        value.pop_back();
+    }
+    return value;
+}
+
+// Last component of the hwmonX/device link: the PCI address, platform device or block device the chip belongs to
+std::string deviceName(const std::string& hwmonDir)
+{
+    char target[PATH_MAX];
+    const auto targetSize = ::readlink((hwmonDir + "/device").c_str(), target, sizeof(target));
+    if (targetSize <= 0) {
+        return {};
+    }
+    const std::string_view targetPath(target, targetSize);
+    const auto slashPos = targetPath.rfind('/');
+    return std::string(slashPos == std::string_view::npos ? targetPath : targetPath.substr(slashPos + 1));
+}
+
+// N of a ".../hwmonN" path; other names go last
+uint32_t hwmonNumber(std::string_view hwmonDir) noexcept
+{
+    const auto numberPos = hwmonDir.rfind("hwmon") + 5;
+    uint32_t number = UINT32_MAX;
+    std::from_chars(hwmonDir.data() + numberPos, hwmonDir.data() + hwmonDir.size(), number);
+    return number;
+}
+
+// Parses names like temp1_input into its parts
+bool parseSensorFileName(std::string_view fileName, const SensorPrefix*& oPrefix, uint16_t& oIndex, std::string_view& oAttribute)
+{
+    for (auto& prefix : SENSOR_PREFIXES) {
+        if (fileName.substr(0, prefix.prefix.size()) != prefix.prefix) {
+            continue;
+        }
+
+        const char* pos = fileName.data() + prefix.prefix.size();
+        const char* end = fileName.data() + fileName.size();
+        auto [ptr, ec] = std::from_chars(pos, end, oIndex);
+        if (ec != std::errc() || ptr == end || *ptr != '_') {
+            return false;
+        }
+        oAttribute = std::string_view(ptr + 1, end - ptr - 1);
+        oPrefix = &prefix;
+        return true;
+    }
+    return false;
+}
+
+bool isReadableAttribute(SensorType type, std::string_view attribute)
+{
+    if (attribute == "input") {
+        return true;
+    }
+    // Power limits and averages are exposed as separate files
+    return type == SensorType::Power &&
+           (attribute == "average" || attribute == "cap" || attribute == "cap_max" || attribute == "cap_min");
+}
+
+} // namespace
+
+HwmonRegistry::HwmonRegistry(const std::string &hwmonRoot) :
+    m_hwmonRoot {hwmonRoot}
+{
+    rescan();
+}
+
+HwmonRegistry::~HwmonRegistry()
+{
+    closeAll();
+}
+
+void HwmonRegistry::rescan()
+{
+    closeAll();
+
+    // An empty root is a registry without sensors (hwmon collection is disabled)
+    if (m_hwmonRoot.empty()) {
+        return;
+    }
+    auto rootDir = opendir(m_hwmonRoot.c_str());
+    if (rootDir == nullptr) {
+        COMPLOG_WARNING("Error opening hwmon directory:", m_hwmonRoot);
+        return;
+    }
+
+    std::vector<std::string> hwmonDirs;
+    while (auto entry = readdir(rootDir)) {
+        if (std::string_view(entry->d_name).substr(0, 5) == "hwmon") {
+            hwmonDirs.push_back(m_hwmonRoot + "/" + entry->d_name);
+        }
+    }
+    closedir(rootDir);
+    // By the number in hwmonX, so hwmon10 comes after hwmon2
+    std::sort(hwmonDirs.begin(), hwmonDirs.end(), [](const std::string& left, const std::string& right) {
+        const auto leftNumber = hwmonNumber(left);
+        const auto rightNumber = hwmonNumber(right);
+        return leftNumber != rightNumber ? leftNumber < rightNumber : left < right;
+    });
+
+    for (auto& hwmonDir : hwmonDirs)
+    {
+        std::string chipName;
+        if (!Filework::Common::readFileData(hwmonDir + "/name", chipName)) {
+            continue;
+        }
+        chipName = trimmed(chipName);
+        const auto device = deviceName(hwmonDir);
+
+        auto sensorsDir = opendir(hwmonDir.c_str());
+        if (sensorsDir == nullptr) {
+            continue;
+        }
+
+        while (auto entry = readdir(sensorsDir))
+        {
+            const SensorPrefix* prefix {};
+            uint16_t index {};
+            std::string_view attribute;
+            if (!parseSensorFileName(entry->d_name, prefix, index, attribute) ||
+                !isReadableAttribute(prefix->type, attribute)) {
+                continue;
+            }
+
+            const auto filePath = hwmonDir + "/" + entry->d_name;
+            const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                continue;
+            }
+
+            HwmonSensor sensor;
+            sensor.chipName  = chipName;
+            sensor.hwmonDir  = hwmonDir;
+            sensor.device    = device;
+            sensor.attribute = std::string(attribute);
+            sensor.type      = prefix->type;
+            sensor.index     = index;
+
+            std::string label;
+            if (Filework::Common::readFileData(hwmonDir + "/" + std::string(prefix->prefix) + std::to_string(index) + "_label", label)) {
+                sensor.label = trimmed(label);
+            }
+
+            m_sensors.push_back(std::move(sensor));
+            m_fds.push_back(fd);
+        }
+        closedir(sensorsDir);
+    }
+}
+
+const std::vector<HwmonSensor> &HwmonRegistry::sensors() const noexcept
+{
+    return m_sensors;
+}
+
+const HwmonSensor *HwmonRegistry::find(SensorType type, std::string_view chipName, uint16_t index, std::string_view attribute,
+                                       std::string_view device) const noexcept
+{
+    for (auto& sensor : m_sensors) {
+        if (sensor.type == type && sensor.index == index && sensor.attribute == attribute &&
+            (chipName.empty() || sensor.chipName == chipName) && (device.empty() || sensor.device == device)) {
+            return &sensor;
+        }
+    }
+    return nullptr;
+}
+
+const HwmonSensor *HwmonRegistry::findCPUTemperature() const noexcept
+{
+    for (auto chipName : CPU_TEMPERATURE_CHIPS) {
+        if (auto pSensor = find(SensorType::Temperature, chipName)) {
+            return pSensor;
+        }
+    }
+    return nullptr;
+}
+
+bool HwmonRegistry::read(const HwmonSensor &sensor, double &oValue) const noexcept
+{
+    const auto sensorPos = static_cast<size_t>(&sensor - m_sensors.data());
+    if (sensorPos >= m_fds.size()) {
+        return false;
+    }
+
+    char buffer[32];
+    SYSTEMPROCESSING_PROBE(probe, "hwmon.read");
+    const auto readBytes = ::pread(m_fds[sensorPos], buffer, sizeof(buffer), 0);
+    probe.addBytes(readBytes);
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+
+    int64_t rawValue {};
+    auto [ptr, ec] = std::from_chars(buffer, buffer + readBytes, rawValue);
+    if (ec != std::errc()) {
+        probe.fail();
+        return false;
+    }
+
+    oValue = rawValue * prefixForType(sensor.type)->scale;
+    return true;
+}
+
+std::optional<double> HwmonRegistry::read(SensorType type, std::string_view chipName, uint16_t index, std::string_view attribute,
+                                          std::string_view device) const noexcept
+{
+    auto pSensor = find(type, chipName, index, attribute, device);
+    double value {};
+    if (pSensor == nullptr || !read(*pSensor, value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+void HwmonRegistry::closeAll() noexcept
+{
+    for (auto fd : m_fds) {
+        ::close(fd);
+    }
+    m_fds.clear();
+    m_sensors.clear();
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace SystemProcessing {
+
+enum class SensorType : uint8_t {
+    Temperature,    // tempN_input, градусы Цельсия
+    Fan,            // fanN_input, обороты в минуту
+    Power           // powerN_*, Ватты
+};
+
+/**
+ * @brief The HwmonSensor struct    Один файл датчика в /sys/class/hwmon/hwmonX
+ */
+struct HwmonSensor
+{
+    std::string chipName;   // Содержимое файла name (k10temp, coretemp, amdgpu, nvme...)
+    std::string hwmonDir;   // Полный путь до hwmonX
+    std::string device;     // Имя устройства из ссылки hwmonX/device (0000:03:00.0, coretemp.0, nvme0). Пустое у виртуальных чипов
+    std::string label;      // Содержимое <type>N_label, если есть
+    std::string attribute;  // Часть имени файла после <type>N_ (input, average, cap...)
+    SensorType type {SensorType::Temperature};
+    uint16_t index {0};     // N из имени файла
+};
+
+/**
+ * @brief The HwmonRegistry class   Реестр датчиков hwmon. Каталог сканируется один раз,
+ *                                  файлы датчиков остаются открытыми и перечитываются через pread
+ */
+class HwmonRegistry
+{
+public:
+    explicit HwmonRegistry(const std::string& hwmonRoot = FsRoot::path("/sys/class/hwmon"));
+    ~HwmonRegistry();
+
+    HwmonRegistry(const HwmonRegistry&) = delete;
+    HwmonRegistry& operator=(const HwmonRegistry&) = delete;
+
+    /**
+     * @brief rescan    Пересканировать каталог (например, после подключения устройства)
+     */
+    void rescan();
+
+    const std::vector<HwmonSensor>& sensors() const noexcept;
+
+    /**
+     * @brief find      Найти датчик
+     * @param chipName  Имя чипа из файла name. Пустое имя — любой чип
+     * @param attribute Для температуры и вентиляторов всегда input
+     * @param device    Имя устройства чипа (HwmonSensor::device), например PCI-адрес видеокарты. Нужно, когда чипов
+     *                  с одним именем несколько (amdgpu на каждой карте, coretemp на каждом сокете). Пустое — первый
+     *                  подходящий чип в порядке hwmonX
+     * @return  nullptr, если датчик не найден
+     */
+    const HwmonSensor* find(SensorType type, std::string_view chipName, uint16_t index = 1,
+                            std::string_view attribute = "input", std::string_view device = {}) const noexcept;
+
+    /**
+     * @brief findCPUTemperature    Датчик температуры процессора (k10temp, coretemp, zenpower...)
+     */
+    const HwmonSensor* findCPUTemperature() const noexcept;
+
+    /**
+     * @brief read  Прочитать значение датчика в единицах SensorType
+     * @return  false при ошибке чтения или если в файле не число
+     */
+    bool read(const HwmonSensor& sensor, double& oValue) const noexcept;
+
+    std::optional<double> read(SensorType type, std::string_view chipName, uint16_t index = 1,
+                               std::string_view attribute = "input", std::string_view device = {}) const noexcept;
+
+private:
+    std::string m_hwmonRoot;
+    std::vector<HwmonSensor> m_sensors;
+    std::vector<int> m_fds; // Индекс совпадает с m_sensors
+
+    void closeAll() noexcept;
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,134 @@
+#include "meminforeader.hpp"
+#include "probestats.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+struct MeminfoKey {
+    std::string_view name;
+    uint64_t MemoryStats::* field;
+};
+
+// In the kernel's output order, so lookups usually hit the next entry
+constexpr MeminfoKey MEMINFO_KEYS[] {
+    {"MemTotal", &MemoryStats::total},
+    {"MemFree", &MemoryStats::free},
+    {"MemAvailable", &MemoryStats::available},
+    {"Buffers", &MemoryStats::buffers},
+    {"Cached", &MemoryStats::cached},
+    {"SwapCached", &MemoryStats::swapCached},
+    {"Active", &MemoryStats::active},
+    {"Inactive", &MemoryStats::inactive},
+    {"SwapTotal", &MemoryStats::swapTotal},
+    {"SwapFree", &MemoryStats::swapFree},
+    {"Dirty", &MemoryStats::dirty},
+    {"Writeback", &MemoryStats::writeback},
+    {"AnonPages", &MemoryStats::anonPages},
+    {"Mapped", &MemoryStats::mapped},
+    {"Shmem", &MemoryStats::shmem},
+    {"Slab", &MemoryStats::slab},
+    {"SReclaimable", &MemoryStats::slabReclaimable},
+    {"SUnreclaim", &MemoryStats::slabUnreclaimable},
+    {"Committed_AS", &MemoryStats::committedAs},
+    {"AnonHugePages", &MemoryStats::anonHugePages},
+    {"HugePages_Total", &MemoryStats::hugePagesTotal},
+    {"HugePages_Free", &MemoryStats::hugePagesFree},
+    {"HugePages_Rsvd", &MemoryStats::hugePagesReserved},
+    {"HugePages_Surp", &MemoryStats::hugePagesSurplus},
+    {"Hugepagesize", &MemoryStats::hugePageSize},
+};
+
+constexpr size_t MEMINFO_KEYS_COUNT = sizeof(MEMINFO_KEYS) / sizeof(MEMINFO_KEYS[0]);
+
+// /proc/meminfo is about 1.5 KiB on current kernels
+constexpr size_t READ_BUFFER_SIZE = 8192;
+
+const MeminfoKey* findKey(std::string_view name, size_t& hint) noexcept
+{
+    for (size_t i = 0; i < MEMINFO_KEYS_COUNT; ++i) {
+        const size_t pos = (hint + i) % MEMINFO_KEYS_COUNT;
+        if (MEMINFO_KEYS[pos].name == name) {
+            hint = pos + 1;
+            return &MEMINFO_KEYS[pos];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+MeminfoReader::MeminfoReader(const std::string &meminfoPath) :
+    m_fd {::open(meminfoPath.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+
+}
+
+MeminfoReader::~MeminfoReader()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool MeminfoReader::isOpened() const noexcept
+{
+    return m_fd >= 0;
+}
+
+bool MeminfoReader::read(MemoryStats &oStats) const noexcept
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    char buffer[READ_BUFFER_SIZE];
+    SYSTEMPROCESSING_PROBE(probe, "meminfo.read");
+    const auto readBytes = ::pread(m_fd, buffer, sizeof(buffer), 0);
+    probe.addBytes(readBytes);
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+
+    oStats = {};
+    size_t hint = 0;
+    const char* pos = buffer;
+    const char* const end = buffer + readBytes;
+    while (pos < end)
+    {
+        auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        // "Key:     12345 kB", HugePages_* have no unit
+        auto colon = static_cast<const char*>(std::memchr(pos, ':', lineEnd - pos));
+        if (colon != nullptr) {
+            if (auto pKey = findKey(std::string_view(pos, colon - pos), hint)) {
+                const char* valuePos = colon + 1;
+                while (valuePos < lineEnd && *valuePos == ' ') {
+                    ++valuePos;
+                }
+                uint64_t value {};
+                auto [ptr, ec] = std::from_chars(valuePos, lineEnd, value);
+                if (ec == std::errc()) {
+                    const bool isKb = (lineEnd - ptr) >= 3 && ptr[1] == 'k';
+                    oStats.*(pKey->field) = isKb ? value * 1024 : value;
+                }
+            }
+        }
+        pos = lineEnd + 1;
+    }
+    return oStats.total != 0;
+}
+
+} // namespace SystemProcessing
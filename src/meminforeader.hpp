@@ -0,0 +1,68 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The MemoryStats struct   Значения из /proc/meminfo. Размеры в байтах, HugePages_* — в страницах
+ */
+struct MemoryStats
+{
+    uint64_t total {0};
+    uint64_t free {0};
+    uint64_t available {0};
+    uint64_t buffers {0};
+    uint64_t cached {0};
+    uint64_t swapCached {0};
+    uint64_t active {0};
+    uint64_t inactive {0};
+    uint64_t swapTotal {0};
+    uint64_t swapFree {0};
+    uint64_t dirty {0};
+    uint64_t writeback {0};
+    uint64_t anonPages {0};
+    uint64_t mapped {0};
+    uint64_t shmem {0};
+    uint64_t slab {0};
+    uint64_t slabReclaimable {0};
+    uint64_t slabUnreclaimable {0};
+    uint64_t committedAs {0};
+    uint64_t anonHugePages {0};
+    uint64_t hugePagesTotal {0};
+    uint64_t hugePagesFree {0};
+    uint64_t hugePagesReserved {0};
+    uint64_t hugePagesSurplus {0};
+    uint64_t hugePageSize {0};
+
+    uint64_t used() const noexcept { return total - free - buffers - cached - slabReclaimable; }
+};
+
+/**
+ * @brief The MeminfoReader class  Чтение /proc/meminfo одним pread в буфер на стеке, файл открыт всё время жизни объекта
+ */
+class MeminfoReader
+{
+public:
+    explicit MeminfoReader(const std::string& meminfoPath = FsRoot::path("/proc/meminfo"));
+    ~MeminfoReader();
+
+    MeminfoReader(const MeminfoReader&) = delete;
+    MeminfoReader& operator=(const MeminfoReader&) = delete;
+
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief read  Прочитать все значения. Отсутствующие в ядре поля остаются нулевыми
+     * @return  false при ошибке чтения
+     */
+    bool read(MemoryStats& oStats) const noexcept;
+
+private:
+    int m_fd {-1};
+};
+
+} // namespace SystemProcessing
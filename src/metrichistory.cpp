@@ -0,0 +1,183 @@
+#include "metrichistory.hpp"
+
+#include <algorithm>
+
+namespace SystemProcessing {
+
+void MetricAggregate::add(double value) noexcept
+{
+    if (count == 0) {
+        min = value;
+        max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    sum += value;
+    count++;
+}
+
+void MetricAggregate::merge(const MetricAggregate &other) noexcept
+{
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    sum += other.sum;
+    count += other.count;
+    timestampNs = std::min(timestampNs, other.timestampNs);
+}
+
+template<typename T>
+void MetricHistory::Ring<T>::push(const T &item) noexcept
+{
+    items[head] = item;
+    head = (head + 1) % items.size();
+    size = std::min(size + 1, items.size());
+}
+
+MetricHistory::MetricHistory(size_t memoryBudgetBytes, const std::vector<std::chrono::nanoseconds> &tierResolutions)
+{
+    const size_t tierBudget = tierResolutions.empty() ? 0 : memoryBudgetBytes / 2 / tierResolutions.size();
+    const size_t rawBudget = memoryBudgetBytes - tierBudget * tierResolutions.size();
+
+    m_raw.items.resize(std::max<size_t>(2, rawBudget / sizeof(MetricPoint)));
+
+    m_tiers.resize(tierResolutions.size());
+    for (size_t i = 0; i < m_tiers.size(); ++i) {
+        m_tiers[i].resolutionNs = std::max<uint64_t>(1, tierResolutions[i].count());
+        m_tiers[i].buckets.items.resize(std::max<size_t>(2, tierBudget / sizeof(MetricAggregate)));
+    }
+}
+
+void MetricHistory::insert(uint64_t timestampNs, double value) noexcept
+{
+    m_raw.push({timestampNs, value});
+
+    for (auto& tier : m_tiers) {
+        const uint64_t bucketStart = timestampNs - timestampNs % tier.resolutionNs;
+        if (tier.buckets.size == 0 || tier.buckets.back().timestampNs != bucketStart) {
+            MetricAggregate bucket;
+            bucket.timestampNs = bucketStart;
+            tier.buckets.push(bucket);
+        }
+        tier.buckets.back().add(value);
+    }
+}
+
+void MetricHistory::clear() noexcept
+{
+    m_raw.head = 0;
+    m_raw.size = 0;
+    for (auto& tier : m_tiers) {
+        tier.buckets.head = 0;
+        tier.buckets.size = 0;
+    }
+}
+
+size_t MetricHistory::rawCapacity() const noexcept
+{
+    return m_raw.items.size();
+}
+
+size_t MetricHistory::rawSize() const noexcept
+{
+    return m_raw.size;
+}
+
+size_t MetricHistory::tierCount() const noexcept
+{
+    return m_tiers.size();
+}
+
+std::chrono::nanoseconds MetricHistory::tierResolution(size_t tier) const noexcept
+{
+    return std::chrono::nanoseconds(tier < m_tiers.size() ? m_tiers[tier].resolutionNs : 0);
+}
+
+bool MetricHistory::query(uint64_t fromNs, uint64_t toNs, MetricAggregate &oResult) const noexcept
+{
+    oResult = {};
+    oResult.timestampNs = fromNs;
+
+    // Raw samples are used while they still cover the beginning of the range
+    if (m_raw.size && m_raw.at(0).timestampNs <= fromNs) {
+        forEachInRange(m_raw, fromNs, toNs, [&oResult](const MetricPoint& point) {
+            oResult.add(point.value);
+        });
+        return oResult.count != 0;
+    }
+
+    const Tier* pTier = nullptr;
+    for (auto& tier : m_tiers) {
+        pTier = &tier;
+        if (tier.buckets.size && tier.buckets.at(0).timestampNs <= fromNs) {
+            break;
+        }
+    }
+
+    if (pTier == nullptr) {
+        forEachInRange(m_raw, fromNs, toNs, [&oResult](const MetricPoint& point) {
+            oResult.add(point.value);
+        });
+        return oResult.count != 0;
+    }
+
+    const uint64_t alignedFrom = fromNs - fromNs % pTier->resolutionNs;
+    forEachInRange(pTier->buckets, alignedFrom, toNs, [&oResult](const MetricAggregate& bucket) {
+        oResult.merge(bucket);
+    });
+    return oResult.count != 0;
+}
+
+size_t MetricHistory::copyRaw(uint64_t fromNs, uint64_t toNs, MetricPoint *oPoints, size_t maxCount) const noexcept
+{
+    size_t copied = 0;
+    forEachInRange(m_raw, fromNs, toNs, [&](const MetricPoint& point) {
+        if (copied < maxCount) {
+            oPoints[copied++] = point;
+        }
+    });
+    return copied;
+}
+
+size_t MetricHistory::copyTier(size_t tier, uint64_t fromNs, uint64_t toNs, MetricAggregate *oBuckets, size_t maxCount) const noexcept
+{
+    if (tier >= m_tiers.size()) {
+        return 0;
+    }
+
+    size_t copied = 0;
+    forEachInRange(m_tiers[tier].buckets, fromNs, toNs, [&](const MetricAggregate& bucket) {
+        if (copied < maxCount) {
+            oBuckets[copied++] = bucket;
+        }
+    });
+    return copied;
+}
+
+template<typename T, typename Visitor>
+void MetricHistory::forEachInRange(const Ring<T> &ring, uint64_t fromNs, uint64_t toNs, Visitor &&visitor) noexcept
+{
+    // Elements are ordered by time, so the first one in range is found by binary search
+    size_t low = 0, high = ring.size;
+    while (low < high) {
+        const size_t mid = (low + high) / 2;
+        if (ring.at(mid).timestampNs < fromNs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    for (size_t pos = low; pos < ring.size && ring.at(pos).timestampNs <= toNs; ++pos) {
+        visitor(ring.at(pos));
+    }
+}
+
+} // namespace SystemProcessing
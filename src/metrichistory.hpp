@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <chrono>
+#include <vector>
+
+namespace SystemProcessing {
+
+struct MetricPoint
+{
+    uint64_t timestampNs {0};
+    double value {0};
+};
+
+/**
+ * @brief The MetricAggregate struct   Свёртка значений за интервал
+ */
+struct MetricAggregate
+{
+    uint64_t timestampNs {0};   // Начало интервала
+    double min {0};
+    double max {0};
+    double sum {0};
+    uint64_t count {0};
+
+    double avg() const noexcept { return count ? sum / count : 0; }
+    void add(double value) noexcept;
+    void merge(const MetricAggregate& other) noexcept;
+};
+
+/**
+ * @brief The MetricHistory class   История одной метрики фиксированного объёма: сырые значения за последнее окно
+ *                                  и уровни min/max/avg с заданным разрешением (по умолчанию 1 с, 10 с, 1 мин).
+ *                                  Вся память выделяется в конструкторе, вставка и запросы без аллокаций.
+ *                                  Не потокобезопасен
+ */
+class MetricHistory
+{
+public:
+    /**
+     * @brief MetricHistory         Создать историю
+     * @param memoryBudgetBytes     Объём памяти: половина на сырые значения, остальное поровну на уровни
+     * @param tierResolutions       Разрешения уровней свёртки по возрастанию
+     */
+    explicit MetricHistory(size_t memoryBudgetBytes,
+                           const std::vector<std::chrono::nanoseconds>& tierResolutions = {
+                               std::chrono::seconds(1), std::chrono::seconds(10), std::chrono::minutes(1)});
+
+    /**
+     * @brief insert    Добавить значение. Метки времени должны не убывать
+     */
+    void insert(uint64_t timestampNs, double value) noexcept;
+
+    void clear() noexcept;
+
+    size_t rawCapacity() const noexcept;
+    size_t rawSize() const noexcept;
+    size_t tierCount() const noexcept;
+    std::chrono::nanoseconds tierResolution(size_t tier) const noexcept;
+
+    /**
+     * @brief query     Свернуть значения за [fromNs, toNs] по самым подробным данным, покрывающим интервал.
+     *                  На уровнях свёртки границы округляются до интервала уровня
+     * @return  false, если в интервале нет данных
+     */
+    bool query(uint64_t fromNs, uint64_t toNs, MetricAggregate& oResult) const noexcept;
+
+    /**
+     * @brief copyRaw   Скопировать сырые значения за [fromNs, toNs] по возрастанию времени
+     * @return  Число скопированных значений (не больше maxCount)
+     */
+    size_t copyRaw(uint64_t fromNs, uint64_t toNs, MetricPoint* oPoints, size_t maxCount) const noexcept;
+
+    /**
+     * @brief copyTier  Скопировать интервалы уровня tier, начавшиеся в [fromNs, toNs], по возрастанию времени
+     * @return  Число скопированных интервалов (не больше maxCount)
+     */
+    size_t copyTier(size_t tier, uint64_t fromNs, uint64_t toNs, MetricAggregate* oBuckets, size_t maxCount) const noexcept;
+
+private:
+    template<typename T>
+    struct Ring
+    {
+        std::vector<T> items;
+        size_t head {0};    // Next write position
+        size_t size {0};
+
+        void push(const T& item) noexcept;
+        T& back() noexcept { return items[(head + items.size() - 1) % items.size()]; }
+        // 0 is the oldest element
+        const T& at(size_t pos) const noexcept { return items[(head + items.size() - size + pos) % items.size()]; }
+    };
+
+    struct Tier
+    {
+        uint64_t resolutionNs {0};
+        Ring<MetricAggregate> buckets;
+    };
+
+    Ring<MetricPoint> m_raw;
+    std::vector<Tier> m_tiers;
+
+    template<typename T, typename Visitor>
+    static void forEachInRange(const Ring<T>& ring, uint64_t fromNs, uint64_t toNs, Visitor&& visitor) noexcept;
+};
+
+} // namespace SystemProcessing
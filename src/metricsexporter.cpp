@@ -0,0 +1,554 @@
+#include "metricsexporter.hpp"
+#include "probestats.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+constexpr size_t REQUEST_BUFFER_SIZE = 4096;
+constexpr int LISTEN_BACKLOG = 16;
+
+// Whole-request and whole-response budgets: a client trickling bytes must not hold the other scrapes for long
+constexpr auto CLIENT_TIMEOUT = std::chrono::seconds(1);
+
+using Deadline = std::chrono::steady_clock::time_point;
+
+constexpr std::string_view CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+constexpr std::string_view NOT_FOUND_RESPONSE =
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+struct MetricFamily
+{
+    std::string_view name;
+    std::string_view unit;
+    std::string_view help;
+};
+
+constexpr MetricFamily CPU_LOAD_FAMILY {"systemprocessing_cpu_load_percent", "percent", "CPU load over the last sampler interval"};
+constexpr MetricFamily CORE_USAGE_FAMILY {"systemprocessing_cpu_core_usage_percent", "percent", "Share of core time by mode"};
+constexpr MetricFamily CPU_TEMPERATURE_FAMILY {"systemprocessing_cpu_temperature_celsius", "celsius", "CPU temperature"};
+constexpr MetricFamily SENSOR_TEMPERATURE_FAMILY {"systemprocessing_hwmon_temperature_celsius", "celsius", "hwmon temperature sensors"};
+constexpr MetricFamily MEMORY_FAMILY {"systemprocessing_memory_bytes", "bytes", "System memory by kind"};
+constexpr MetricFamily SWAP_FAMILY {"systemprocessing_swap_bytes", "bytes", "Swap space by kind"};
+constexpr MetricFamily UPTIME_FAMILY {"systemprocessing_uptime_seconds", "seconds", "System uptime"};
+constexpr MetricFamily LOAD_AVERAGE_FAMILY {"systemprocessing_load_average", "", "Run queue load average"};
+constexpr MetricFamily PROCESSES_FAMILY {"systemprocessing_processes", "", "Number of processes"};
+constexpr MetricFamily PRESSURE_FAMILY {"systemprocessing_pressure_avg10_percent", "percent", "Pressure stall information, 10 second average"};
+constexpr MetricFamily NUMA_LOAD_FAMILY {"systemprocessing_numa_node_load_percent", "percent", "Average load of the NUMA node cores"};
+constexpr MetricFamily NUMA_MEMORY_FAMILY {"systemprocessing_numa_node_memory_bytes", "bytes", "NUMA node memory by kind"};
+constexpr MetricFamily IPC_FAMILY {"systemprocessing_perf_instructions_per_cycle", "", "Instructions per cycle, zero without hardware PMU"};
+constexpr MetricFamily CONTEXT_SWITCHES_FAMILY {"systemprocessing_perf_context_switches_per_second", "", "Context switches rate"};
+constexpr MetricFamily PAGE_FAULTS_FAMILY {"systemprocessing_perf_page_faults_per_second", "", "Page faults rate"};
+constexpr MetricFamily CACHE_MISSES_FAMILY {"systemprocessing_perf_cache_misses_per_second", "", "Cache misses rate, zero without hardware PMU"};
+constexpr MetricFamily POWER_FAMILY {"systemprocessing_power_watts", "watts", "RAPL power by domain"};
+
+constexpr std::string_view CORE_MODES[] {"user", "system", "iowait", "steal", "idle"};
+constexpr std::string_view PRESSURE_RESOURCES[] {"cpu", "memory", "io"};
+
+void appendFamily(std::string& oText, const MetricFamily& family)
+{
+    oText.append("# TYPE ").append(family.name).append(" gauge\n");
+    if (!family.unit.empty()) {
+        oText.append("# UNIT ").append(family.name).append(" ").append(family.unit).append("\n");
+    }
+    oText.append("# HELP ").append(family.name).append(" ").append(family.help).append("\n");
+}
+
+void appendValue(std::string& oText, std::string_view prefix, double value)
+{
+    oText.append(prefix);
+    if (std::isnan(value)) {
+        oText.append("NaN\n");
+        return;
+    }
+    char buffer[32];
+    const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    oText.append(buffer, ptr).push_back('\n');
+}
+
+// The snapshot keeps per core and per sensor values as float; widening them to double prints the rounding noise
+void appendValue(std::string& oText, std::string_view prefix, float value)
+{
+    oText.append(prefix);
+    if (std::isnan(value)) {
+        oText.append("NaN\n");
+        return;
+    }
+    char buffer[32];
+    const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    oText.append(buffer, ptr).push_back('\n');
+}
+
+void appendValue(std::string& oText, std::string_view prefix, uint64_t value)
+{
+    char buffer[24];
+    const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    oText.append(prefix).append(buffer, ptr).push_back('\n');
+}
+
+// Unlabeled sample: "name value"
+void appendSample(std::string& oText, const MetricFamily& family, double value)
+{
+    oText.append(family.name).push_back(' ');
+    appendValue(oText, {}, value);
+}
+
+// One labeled sample; used for the fixed label sets, which are few
+void appendSample(std::string& oText, const MetricFamily& family, std::string_view labels, double value)
+{
+    oText.append(family.name).append("{").append(labels).append("} ");
+    appendValue(oText, {}, value);
+}
+
+void appendSample(std::string& oText, const MetricFamily& family, std::string_view labels, uint64_t value)
+{
+    oText.append(family.name).append("{").append(labels).append("} ");
+    appendValue(oText, {}, value);
+}
+
+std::string samplePrefix(const MetricFamily& family, std::string_view labels)
+{
+    std::string result;
+    result.reserve(family.name.size() + labels.size() + 3);
+    result.append(family.name).append("{").append(labels).append("} ");
+    return result;
+}
+
+// Waits for the socket until the deadline; false once it has passed
+bool waitClient(int fd, short events, Deadline deadline) noexcept
+{
+    while (true)
+    {
+        const auto remainingMs = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remainingMs <= 0) {
+            return false;
+        }
+        pollfd pollFd {fd, events, 0};
+        const int readyCount = ::poll(&pollFd, 1, static_cast<int>(remainingMs));
+        if (readyCount < 0 && errno == EINTR) {
+            continue;
+        }
+        return readyCount > 0;
+    }
+}
+
+bool sendAll(int fd, std::string_view data, Deadline deadline) noexcept
+{
+    while (!data.empty()) {
+        if (!waitClient(fd, POLLOUT, deadline)) {
+            return false;
+        }
+        const auto sentBytes = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sentBytes < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(sentBytes);
+    }
+    return true;
+}
+
+// A socket file left by a previous run makes bind fail. Only a socket nobody listens on is removed:
+// a regular file at a mistyped path or the live socket of another exporter stays
+bool removeStaleSocket(const std::string& socketPath, const sockaddr_un& socketAddress) noexcept
+{
+    struct stat socketStat;
+    if (::lstat(socketPath.c_str(), &socketStat) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(socketStat.st_mode)) {
+        COMPLOG_WARNING("Exporter socket path is taken by a file that is not a socket:", socketPath);
+        return false;
+    }
+
+    const int probeFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probeFd < 0) {
+        return false;
+    }
+    const bool isRefused = ::connect(probeFd, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0
+            && errno == ECONNREFUSED;
+    ::close(probeFd);
+    if (!isRefused) {
+        COMPLOG_WARNING("Exporter socket is in use by another exporter:", socketPath);
+        return false;
+    }
+    return ::unlink(socketPath.c_str()) == 0 || errno == ENOENT;
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(const std::string &address, std::vector<std::string> sensorLabels) :
+    m_address {address},
+    m_text {"# EOF\n"}
+{
+    m_sensorPrefixes.reserve(sensorLabels.size());
+    for (auto& labels : sensorLabels) {
+        m_sensorPrefixes.push_back(samplePrefix(SENSOR_TEMPERATURE_FAMILY, labels));
+    }
+
+    if (!listen()) {
+        return;
+    }
+    m_stopFd = ::eventfd(0, EFD_CLOEXEC);
+    m_serverThread = std::thread(&MetricsExporter::serverLoop, this);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    if (m_serverThread.joinable()) {
+        const uint64_t stopValue = 1;
+        [[maybe_unused]] auto writtenBytes = ::write(m_stopFd, &stopValue, sizeof(stopValue));
+        m_serverThread.join();
+    }
+    if (m_stopFd >= 0) {
+        ::close(m_stopFd);
+    }
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        struct stat socketStat;
+        if (!m_unixPath.empty() && ::stat(m_unixPath.c_str(), &socketStat) == 0
+                && socketStat.st_dev == m_unixDevice && socketStat.st_ino == m_unixInode) {
+            ::unlink(m_unixPath.c_str());
+        }
+    }
+}
+
+bool MetricsExporter::isOpened() const noexcept
+{
+    return m_listenFd >= 0;
+}
+
+const std::string &MetricsExporter::address() const noexcept
+{
+    return m_address;
+}
+
+void MetricsExporter::update(const StatusSnapshot &snapshot) noexcept
+{
+    std::lock_guard lock(m_snapshotMx);
+    m_latestSnapshot = snapshot;
+    ++m_latestSequence;
+}
+
+void MetricsExporter::render(const StatusSnapshot &snapshot, std::string &oText)
+{
+    oText.clear();
+
+    appendFamily(oText, CPU_LOAD_FAMILY);
+    appendSample(oText, CPU_LOAD_FAMILY, snapshot.cpuLoad);
+
+    updateCorePrefixes(snapshot);
+    appendFamily(oText, CORE_USAGE_FAMILY);
+    const float* coreModes[] {snapshot.coreUser, snapshot.coreSystem, snapshot.coreIowait, snapshot.coreSteal, snapshot.coreIdle};
+    for (size_t core = 0; core < snapshot.coreCount; ++core) {
+        for (size_t mode = 0; mode < std::size(coreModes); ++mode) {
+            appendValue(oText, m_corePrefixes[core * std::size(CORE_MODES) + mode], coreModes[mode][core]);
+        }
+    }
+
+    appendFamily(oText, CPU_TEMPERATURE_FAMILY);
+    appendSample(oText, CPU_TEMPERATURE_FAMILY, snapshot.cpuTemperature);
+
+    appendFamily(oText, SENSOR_TEMPERATURE_FAMILY);
+    for (size_t i = 0; i < snapshot.temperatureCount; ++i)
+    {
+        const auto& entry = snapshot.temperatures[i];
+        // Sensors found by a rescan after the exporter was created are labeled by their index
+        while (entry.sensorIndex >= m_sensorPrefixes.size()) {
+            m_sensorPrefixes.push_back(samplePrefix(SENSOR_TEMPERATURE_FAMILY,
+                                                    "sensor=\"" + std::to_string(m_sensorPrefixes.size()) + "\""));
+        }
+        appendValue(oText, m_sensorPrefixes[entry.sensorIndex], entry.celsius);
+    }
+
+    appendFamily(oText, MEMORY_FAMILY);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"total\"", snapshot.memoryTotal);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"free\"", snapshot.memoryFree);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"available\"", snapshot.memoryAvailable);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"shared\"", snapshot.memoryShared);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"buffers\"", snapshot.memoryBuffers);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"cached\"", snapshot.memoryCached);
+    appendSample(oText, MEMORY_FAMILY, "kind=\"dirty\"", snapshot.memoryDirty);
+
+    appendFamily(oText, SWAP_FAMILY);
+    appendSample(oText, SWAP_FAMILY, "kind=\"total\"", snapshot.swapTotal);
+    appendSample(oText, SWAP_FAMILY, "kind=\"free\"", snapshot.swapFree);
+
+    appendFamily(oText, UPTIME_FAMILY);
+    appendSample(oText, UPTIME_FAMILY, double(snapshot.uptimeSec));
+
+    appendFamily(oText, LOAD_AVERAGE_FAMILY);
+    appendSample(oText, LOAD_AVERAGE_FAMILY, "period=\"1m\"", snapshot.loadAverage[0]);
+    appendSample(oText, LOAD_AVERAGE_FAMILY, "period=\"5m\"", snapshot.loadAverage[1]);
+    appendSample(oText, LOAD_AVERAGE_FAMILY, "period=\"15m\"", snapshot.loadAverage[2]);
+
+    appendFamily(oText, PROCESSES_FAMILY);
+    appendSample(oText, PROCESSES_FAMILY, double(snapshot.processCount));
+
+    appendFamily(oText, PRESSURE_FAMILY);
+    for (size_t resource = 0; resource < std::size(PRESSURE_RESOURCES); ++resource) {
+        oText.append(PRESSURE_FAMILY.name).append("{resource=\"").append(PRESSURE_RESOURCES[resource]).append("\",kind=\"some\"} ");
+        appendValue(oText, {}, snapshot.pressureSomeAvg10[resource]);
+        oText.append(PRESSURE_FAMILY.name).append("{resource=\"").append(PRESSURE_RESOURCES[resource]).append("\",kind=\"full\"} ");
+        appendValue(oText, {}, snapshot.pressureFullAvg10[resource]);
+    }
+
+    updateNodePrefixes(snapshot);
+    appendFamily(oText, NUMA_LOAD_FAMILY);
+    for (size_t node = 0; node < snapshot.numaNodeCount; ++node) {
+        appendValue(oText, m_nodePrefixes[node * 3], snapshot.numaNodes[node].load);
+    }
+    appendFamily(oText, NUMA_MEMORY_FAMILY);
+    for (size_t node = 0; node < snapshot.numaNodeCount; ++node) {
+        appendValue(oText, m_nodePrefixes[node * 3 + 1], snapshot.numaNodes[node].memoryTotal);
+        appendValue(oText, m_nodePrefixes[node * 3 + 2], snapshot.numaNodes[node].memoryFree);
+    }
+
+    appendFamily(oText, IPC_FAMILY);
+    appendSample(oText, IPC_FAMILY, snapshot.ipc);
+    appendFamily(oText, CONTEXT_SWITCHES_FAMILY);
+    appendSample(oText, CONTEXT_SWITCHES_FAMILY, snapshot.contextSwitchesPerSec);
+    appendFamily(oText, PAGE_FAULTS_FAMILY);
+    appendSample(oText, PAGE_FAULTS_FAMILY, snapshot.pageFaultsPerSec);
+    appendFamily(oText, CACHE_MISSES_FAMILY);
+    appendSample(oText, CACHE_MISSES_FAMILY, snapshot.cacheMissesPerSec);
+
+    appendFamily(oText, POWER_FAMILY);
+    appendSample(oText, POWER_FAMILY, "domain=\"package\"", snapshot.cpuPackageWatts);
+    appendSample(oText, POWER_FAMILY, "domain=\"core\"", snapshot.cpuCoreWatts);
+    appendSample(oText, POWER_FAMILY, "domain=\"dram\"", snapshot.dramWatts);
+
+    oText.append("# EOF\n");
+}
+
+std::string MetricsExporter::escapeLabelValue(std::string_view value)
+{
+    std::string result;
+    result.reserve(value.size());
+    for (auto symbol : value) {
+        switch (symbol)
+        {
+        case '\\':  result.append("\\\\"); break;
+        case '"':   result.append("\\\""); break;
+        case '\n':  result.append("\\n"); break;
+        default:    result.push_back(symbol); break;
+        }
+    }
+    return result;
+}
+
+bool MetricsExporter::listen()
+{
+    const std::string_view address = m_address;
+    bool isBound = false;
+    if (address.substr(0, 5) == "unix:")
+    {
+        m_unixPath = m_address.substr(5);
+        sockaddr_un socketAddress {};
+        socketAddress.sun_family = AF_UNIX;
+        if (m_unixPath.empty() || m_unixPath.size() >= sizeof(socketAddress.sun_path)) {
+            COMPLOG_WARNING("Invalid exporter socket path:", m_unixPath);
+            m_unixPath.clear();
+            return false;
+        }
+        std::memcpy(socketAddress.sun_path, m_unixPath.c_str(), m_unixPath.size() + 1);
+
+        if (!removeStaleSocket(m_unixPath, socketAddress)) {
+            m_unixPath.clear();
+            return false;
+        }
+
+        m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        isBound = m_listenFd >= 0
+                && ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) == 0;
+        struct stat socketStat;
+        if (isBound && ::stat(m_unixPath.c_str(), &socketStat) == 0) {
+            m_unixDevice = socketStat.st_dev;
+            m_unixInode = socketStat.st_ino;
+        } else if (!isBound) {
+            m_unixPath.clear();
+        }
+    }
+    else
+    {
+        const auto colonPos = address.rfind(':');
+        uint16_t port {0};
+        sockaddr_in socketAddress {};
+        socketAddress.sin_family = AF_INET;
+        const std::string host(address.substr(0, colonPos == std::string_view::npos ? 0 : colonPos));
+        if (colonPos == std::string_view::npos
+                || std::from_chars(address.data() + colonPos + 1, address.data() + address.size(), port).ec != std::errc()
+                || ::inet_pton(AF_INET, host.c_str(), &socketAddress.sin_addr) != 1) {
+            COMPLOG_WARNING("Invalid exporter address, expected \"127.0.0.1:port\" or \"unix:/path\":", m_address);
+            return false;
+        }
+        socketAddress.sin_port = htons(port);
+
+        m_listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int reuseAddress = 1;
+        if (m_listenFd >= 0) {
+            ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+        }
+        isBound = m_listenFd >= 0
+                && ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) == 0;
+    }
+
+    if (isBound && ::listen(m_listenFd, LISTEN_BACKLOG) == 0) {
+        return true;
+    }
+    COMPLOG_WARNING("Error opening exporter socket:", m_address, std::strerror(errno));
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        m_listenFd = -1;
+    }
+    return false;
+}
+
+void MetricsExporter::serverLoop()
+{
+    pollfd pollFds[2] {
+        {m_listenFd, POLLIN, 0},
+        {m_stopFd, POLLIN, 0},
+    };
+    while (true)
+    {
+        if (::poll(pollFds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            COMPLOG_WARNING("Exporter poll error:", std::strerror(errno));
+            return;
+        }
+        if (pollFds[1].revents != 0) {
+            return;
+        }
+        if (pollFds[0].revents & POLLIN) {
+            const int clientFd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (clientFd >= 0) {
+                serveClient(clientFd);
+                ::close(clientFd);
+            }
+        }
+    }
+}
+
+void MetricsExporter::serveClient(int clientFd)
+{
+    // Only the request line matters; headers are read to the end so the client doesn't get a reset
+    const auto requestDeadline = std::chrono::steady_clock::now() + CLIENT_TIMEOUT;
+    char request[REQUEST_BUFFER_SIZE];
+    size_t receivedBytes = 0;
+    while (receivedBytes < sizeof(request))
+    {
+        if (!waitClient(clientFd, POLLIN, requestDeadline)) {
+            return;
+        }
+        const auto readBytes = ::recv(clientFd, request + receivedBytes, sizeof(request) - receivedBytes, MSG_DONTWAIT);
+        if (readBytes < 0 && (errno == EINTR || errno == EAGAIN)) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            return;
+        }
+        receivedBytes += readBytes;
+        if (std::string_view(request, receivedBytes).find("\r\n\r\n") != std::string_view::npos) {
+            break;
+        }
+    }
+
+    SYSTEMPROCESSING_PROBE(probe, "exporter.scrape");
+    std::string_view requestLine(request, receivedBytes);
+    requestLine = requestLine.substr(0, requestLine.find("\r\n"));
+    if (requestLine.substr(0, 13) != "GET /metrics " && requestLine.substr(0, 6) != "GET / ") {
+        sendAll(clientFd, NOT_FOUND_RESPONSE, std::chrono::steady_clock::now() + CLIENT_TIMEOUT);
+        probe.fail();
+        return;
+    }
+
+    uint64_t sequence {0};
+    {
+        std::lock_guard lock(m_snapshotMx);
+        sequence = m_latestSequence;
+        if (sequence != m_renderedSequence) {
+            m_renderSnapshot = m_latestSnapshot;
+        }
+    }
+    if (sequence != m_renderedSequence) {
+        render(m_renderSnapshot, m_text);
+        m_renderedSequence = sequence;
+    }
+
+    char lengthText[24];
+    const auto [lengthEnd, ec] = std::to_chars(lengthText, lengthText + sizeof(lengthText), m_text.size());
+    m_header.clear();
+    m_header.append("HTTP/1.1 200 OK\r\nContent-Type: ").append(CONTENT_TYPE)
+            .append("\r\nContent-Length: ").append(lengthText, lengthEnd)
+            .append("\r\nConnection: close\r\n\r\n");
+    const auto responseDeadline = std::chrono::steady_clock::now() + CLIENT_TIMEOUT;
+    if (!sendAll(clientFd, m_header, responseDeadline) || !sendAll(clientFd, m_text, responseDeadline)) {
+        probe.fail();
+        return;
+    }
+    probe.addBytes(m_header.size() + m_text.size());
+}
+
+void MetricsExporter::updateCorePrefixes(const StatusSnapshot &snapshot)
+{
+    if (m_prefixCoreIds.size() == snapshot.coreCount
+            && std::equal(m_prefixCoreIds.begin(), m_prefixCoreIds.end(), snapshot.coreIds)) {
+        return;
+    }
+
+    m_prefixCoreIds.assign(snapshot.coreIds, snapshot.coreIds + snapshot.coreCount);
+    m_corePrefixes.clear();
+    for (auto coreId : m_prefixCoreIds) {
+        for (auto mode : CORE_MODES) {
+            m_corePrefixes.push_back(samplePrefix(CORE_USAGE_FAMILY,
+                                                  "cpu=\"" + std::to_string(coreId) + "\",mode=\"" + std::string(mode) + "\""));
+        }
+    }
+}
+
+void MetricsExporter::updateNodePrefixes(const StatusSnapshot &snapshot)
+{
+    bool isSame = m_prefixNodeIds.size() == snapshot.numaNodeCount;
+    for (size_t node = 0; isSame && node < snapshot.numaNodeCount; ++node) {
+        isSame = m_prefixNodeIds[node] == snapshot.numaNodes[node].nodeId;
+    }
+    if (isSame) {
+        return;
+    }
+
+    m_prefixNodeIds.clear();
+    m_nodePrefixes.clear();
+    for (size_t node = 0; node < snapshot.numaNodeCount; ++node) {
+        const auto nodeLabel = "node=\"" + std::to_string(snapshot.numaNodes[node].nodeId) + "\"";
+        m_prefixNodeIds.push_back(snapshot.numaNodes[node].nodeId);
+        m_nodePrefixes.push_back(samplePrefix(NUMA_LOAD_FAMILY, nodeLabel));
+        m_nodePrefixes.push_back(samplePrefix(NUMA_MEMORY_FAMILY, nodeLabel + ",kind=\"total\""));
+        m_nodePrefixes.push_back(samplePrefix(NUMA_MEMORY_FAMILY, nodeLabel + ",kind=\"free\""));
+    }
+}
+
+} // namespace SystemProcessing
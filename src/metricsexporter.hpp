@@ -0,0 +1,90 @@
+#pragma once
+
+#include "statussnapshot.hpp"
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The MetricsExporter class    Отдача StatusSnapshot в формате OpenMetrics (Prometheus) по HTTP.
+ *                                      Слушает localhost или UNIX-сокет в своём потоке. Снимок приходит
+ *                                      от сэмплера через update(), запросы только форматируют последний снимок
+ *                                      в переиспользуемый буфер и не читают /proc и /sys. Запросы обслуживаются
+ *                                      по очереди, на чтение запроса и на отправку ответа клиенту даётся по секунде
+ *                                      целиком. Текст пересобирается только после нового снимка
+ */
+class MetricsExporter
+{
+public:
+    static constexpr const char* DEFAULT_ADDRESS = "127.0.0.1:9464";
+
+    /**
+     * @param address       "127.0.0.1:9464" — TCP на адресе IPv4, "unix:/run/systemprocessing.sock" — UNIX-сокет
+     * @param sensorLabels  Метки датчиков по индексам HwmonRegistry::sensors(), например chip="coretemp",sensor="Core 0"
+     */
+    explicit MetricsExporter(const std::string& address = DEFAULT_ADDRESS, std::vector<std::string> sensorLabels = {});
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool isOpened() const noexcept;
+    const std::string& address() const noexcept;
+
+    /**
+     * @brief update    Новый снимок для следующих запросов. Вызывается сэмплером
+     */
+    void update(const StatusSnapshot& snapshot) noexcept;
+
+    /**
+     * @brief escapeLabelValue  Экранировать \, " и перевод строки для значения метки
+     */
+    static std::string escapeLabelValue(std::string_view value);
+
+private:
+    std::string m_address;
+    std::string m_unixPath;
+    uint64_t m_unixDevice {0};  // The socket file we bound; another exporter may replace it at the same path
+    uint64_t m_unixInode {0};
+    int m_listenFd {-1};
+    int m_stopFd {-1};
+    std::thread m_serverThread;
+
+    std::mutex m_snapshotMx;
+    StatusSnapshot m_latestSnapshot {};
+    uint64_t m_latestSequence {0};  // Число update(), 0 — снимка ещё нет
+
+    // Only the server thread touches these
+    StatusSnapshot m_renderSnapshot {};
+    uint64_t m_renderedSequence {0};
+    std::string m_text;
+    std::string m_header;
+
+    // Metric name with labels up to the value, e.g. 'systemprocessing_cpu_core_usage_percent{cpu="3",mode="user"} '
+    std::vector<std::string> m_sensorPrefixes;
+    std::vector<uint32_t> m_prefixCoreIds;
+    std::vector<std::string> m_corePrefixes;    // 5 per core: user, system, iowait, steal, idle
+    std::vector<int32_t> m_prefixNodeIds;
+    std::vector<std::string> m_nodePrefixes;    // 3 per node: load, memory total, memory free
+
+    bool listen();
+    void serverLoop();
+
+    /**
+     * @brief render    Текст OpenMetrics снимка, заканчивается "# EOF". Буфер очищается, ёмкость сохраняется.
+     *                  Обновляет кэши префиксов, поэтому вызывается только из потока сервера
+     */
+    void render(const StatusSnapshot& snapshot, std::string& oText);
+    void serveClient(int clientFd);
+    void updateCorePrefixes(const StatusSnapshot& snapshot);
+    void updateNodePrefixes(const StatusSnapshot& snapshot);
+};
+
+} // namespace SystemProcessing
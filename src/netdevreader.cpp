@@ -0,0 +1,120 @@
+#include "netdevreader.hpp"
+#include "probestats.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Two header lines plus about 130 bytes per interface
+constexpr size_t READ_BUFFER_SIZE = 32768;
+
+// Column order of /proc/net/dev after "iface:"
+enum NetDevColumn : uint8_t {
+    RxBytes, RxPackets, RxErrors, RxDropped, RxFifo, RxFrame, RxCompressed, RxMulticast,
+    TxBytes, TxPackets, TxErrors, TxDropped,
+    ColumnsUsed
+};
+
+} // namespace
+
+NetDevReader::NetDevReader(const std::string &netDevPath) :
+    m_fd {::open(netDevPath.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+
+}
+
+NetDevReader::~NetDevReader()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool NetDevReader::isOpened() const noexcept
+{
+    return m_fd >= 0;
+}
+
+bool NetDevReader::read(std::vector<NetworkInterfaceStats> &oInterfaces, bool skipLoopback) const
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    char buffer[READ_BUFFER_SIZE];
+    SYSTEMPROCESSING_PROBE(probe, "netdev.read");
+    const auto readBytes = ::pread(m_fd, buffer, sizeof(buffer), 0);
+    probe.addBytes(readBytes);
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+
+    size_t count = 0;
+    const char* pos = buffer;
+    const char* const end = buffer + readBytes;
+    while (pos < end)
+    {
+        auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        // Header lines have no colon
+        auto colon = static_cast<const char*>(std::memchr(pos, ':', lineEnd - pos));
+        if (colon == nullptr) {
+            pos = lineEnd + 1;
+            continue;
+        }
+
+        std::string_view name(pos, colon - pos);
+        while (!name.empty() && name.front() == ' ') {
+            name.remove_prefix(1);
+        }
+        if (skipLoopback && name == "lo") {
+            pos = lineEnd + 1;
+            continue;
+        }
+
+        uint64_t columns[ColumnsUsed] {};
+        const char* valuePos = colon + 1;
+        for (size_t column = 0; column < ColumnsUsed && valuePos < lineEnd; ++column) {
+            while (valuePos < lineEnd && *valuePos == ' ') {
+                ++valuePos;
+            }
+            auto [ptr, ec] = std::from_chars(valuePos, lineEnd, columns[column]);
+            if (ec != std::errc()) {
+                break;
+            }
+            valuePos = ptr;
+        }
+
+        if (count == oInterfaces.size()) {
+            oInterfaces.emplace_back();
+        }
+        auto& rInterface = oInterfaces[count++];
+        rInterface.name.assign(name.data(), name.size());
+        rInterface.rxBytes = columns[RxBytes];
+        rInterface.rxPackets = columns[RxPackets];
+        rInterface.rxErrors = columns[RxErrors];
+        rInterface.rxDropped = columns[RxDropped];
+        rInterface.txBytes = columns[TxBytes];
+        rInterface.txPackets = columns[TxPackets];
+        rInterface.txErrors = columns[TxErrors];
+        rInterface.txDropped = columns[TxDropped];
+
+        pos = lineEnd + 1;
+    }
+    oInterfaces.resize(count);
+    return true;
+}
+
+} // namespace SystemProcessing
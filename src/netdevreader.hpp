@@ -0,0 +1,54 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The NetworkInterfaceStats struct Счётчики интерфейса из /proc/net/dev
+ */
+struct NetworkInterfaceStats
+{
+    std::string name;
+    uint64_t rxBytes {0};
+    uint64_t rxPackets {0};
+    uint64_t rxErrors {0};
+    uint64_t rxDropped {0};
+    uint64_t txBytes {0};
+    uint64_t txPackets {0};
+    uint64_t txErrors {0};
+    uint64_t txDropped {0};
+};
+
+/**
+ * @brief The NetDevReader class   Читатель /proc/net/dev: файл открыт всё время жизни объекта,
+ *                                 перечитывается через pread. Память выделяется только при росте числа интерфейсов
+ */
+class NetDevReader
+{
+public:
+    explicit NetDevReader(const std::string& netDevPath = FsRoot::path("/proc/net/dev"));
+    ~NetDevReader();
+
+    NetDevReader(const NetDevReader&) = delete;
+    NetDevReader& operator=(const NetDevReader&) = delete;
+
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief read  Прочитать счётчики всех интерфейсов
+     * @param skipLoopback  Не включать lo
+     * @return  false при ошибке чтения
+     */
+    bool read(std::vector<NetworkInterfaceStats>& oInterfaces, bool skipLoopback = true) const;
+
+private:
+    int m_fd {-1};
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,264 @@
+#include "numatopology.hpp"
+#include "procstatreader.hpp"
+#include "probestats.hpp"
+#include "sysutil.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+struct NodeMeminfoKey {
+    std::string_view name;
+    uint64_t NodeMemoryStats::* field;
+};
+
+constexpr NodeMeminfoKey NODE_MEMINFO_KEYS[] {
+    {"MemTotal", &NodeMemoryStats::total},
+    {"MemFree", &NodeMemoryStats::free},
+    {"MemUsed", &NodeMemoryStats::used},
+    {"Active", &NodeMemoryStats::active},
+    {"Inactive", &NodeMemoryStats::inactive},
+    {"FilePages", &NodeMemoryStats::filePages},
+    {"AnonPages", &NodeMemoryStats::anonPages},
+    {"Shmem", &NodeMemoryStats::shmem},
+    {"Slab", &NodeMemoryStats::slab},
+    {"HugePages_Total", &NodeMemoryStats::hugePagesTotal},
+    {"HugePages_Free", &NodeMemoryStats::hugePagesFree},
+};
+
+// nodeN/meminfo is about 1.2 KiB
+constexpr size_t READ_BUFFER_SIZE = 4096;
+
+int parseNode(const std::string& text) noexcept
+{
+    int node = NumaTopology::UNKNOWN_NODE;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), node);
+    return ec == std::errc() && node >= 0 ? node : NumaTopology::UNKNOWN_NODE;
+}
+
+} // namespace
+
+NumaTopology::NumaTopology(const std::string &nodeRoot)
+{
+    if (auto pDir = ::opendir(nodeRoot.c_str()))
+    {
+        while (auto pEntry = ::readdir(pDir))
+        {
+            if (std::strncmp(pEntry->d_name, "node", 4) != 0) {
+                continue;
+            }
+            NumaNode node;
+            auto [ptr, ec] = std::from_chars(pEntry->d_name + 4, pEntry->d_name + std::strlen(pEntry->d_name), node.id);
+            if (ec != std::errc() || *ptr != '\0') {
+                continue;
+            }
+
+            const auto nodePath = nodeRoot + "/" + pEntry->d_name;
+            parseCPUList(readSmallFile(nodePath + "/cpulist"), node.cpus);
+            m_nodes.push_back(std::move(node));
+        }
+        ::closedir(pDir);
+    }
+    std::sort(m_nodes.begin(), m_nodes.end(), [](auto& first, auto& second) { return first.id < second.id; });
+
+    if (m_nodes.empty()) {
+        NumaNode node;
+        const auto cpusCount = ::sysconf(_SC_NPROCESSORS_CONF);
+        for (long cpu = 0; cpu < cpusCount; ++cpu) {
+            node.cpus.push_back(static_cast<uint32_t>(cpu));
+        }
+        m_nodes.push_back(std::move(node));
+    }
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const auto meminfoPath = nodeRoot + "/node" + std::to_string(m_nodes[i].id) + "/meminfo";
+        m_meminfoFds.push_back(::open(meminfoPath.c_str(), O_RDONLY | O_CLOEXEC));
+
+        for (auto cpu : m_nodes[i].cpus) {
+            if (cpu >= m_cpuNodeIndexes.size()) {
+                m_cpuNodeIndexes.resize(cpu + 1, -1);
+            }
+            m_cpuNodeIndexes[cpu] = static_cast<int>(i);
+        }
+    }
+}
+
+NumaTopology::~NumaTopology()
+{
+    for (auto fd : m_meminfoFds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+const std::vector<NumaNode> &NumaTopology::nodes() const noexcept
+{
+    return m_nodes;
+}
+
+size_t NumaTopology::nodeCount() const noexcept
+{
+    return m_nodes.size();
+}
+
+int NumaTopology::nodeIndex(uint32_t cpu) const noexcept
+{
+    return cpu < m_cpuNodeIndexes.size() ? m_cpuNodeIndexes[cpu] : -1;
+}
+
+bool NumaTopology::readMemory(size_t nodeIndex, NodeMemoryStats &oStats) const noexcept
+{
+    if (nodeIndex >= m_meminfoFds.size() || m_meminfoFds[nodeIndex] < 0) {
+        return false;
+    }
+
+    char buffer[READ_BUFFER_SIZE];
+    SYSTEMPROCESSING_PROBE(probe, "numa.meminfo.read");
+    const auto readBytes = ::pread(m_meminfoFds[nodeIndex], buffer, sizeof(buffer), 0);
+    probe.addBytes(readBytes);
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+
+    // "Node 0 MemTotal:       16318508 kB"
+    oStats = {};
+    std::string_view text(buffer, readBytes);
+    while (!text.empty())
+    {
+        auto lineEnd = text.find('\n');
+        auto line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        const auto nodeEnd = line.find(' ', 5);
+        const auto colonPos = line.find(':');
+        if (nodeEnd == std::string_view::npos || colonPos == std::string_view::npos || colonPos < nodeEnd) {
+            continue;
+        }
+        const auto name = line.substr(nodeEnd + 1, colonPos - nodeEnd - 1);
+        auto valueText = line.substr(colonPos + 1);
+        while (!valueText.empty() && valueText.front() == ' ') {
+            valueText.remove_prefix(1);
+        }
+
+        for (auto& key : NODE_MEMINFO_KEYS) {
+            if (key.name != name) {
+                continue;
+            }
+            uint64_t value {0};
+            auto [ptr, ec] = std::from_chars(valueText.data(), valueText.data() + valueText.size(), value);
+            if (ec == std::errc()) {
+                const bool isKilobytes = valueText.substr(ptr - valueText.data()) == " kB";
+                oStats.*key.field = isKilobytes ? value * 1024 : value;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+void NumaTopology::aggregateLoad(const CPUCoresLoad &coresLoad, std::vector<double> &oNodesLoad) const
+{
+    // Counts go into the tail of the same buffer to avoid a second allocation
+    oNodesLoad.assign(m_nodes.size() * 2, 0);
+    for (size_t i = 0; i < coresLoad.coreCount(); ++i) {
+        const int node = nodeIndex(coresLoad.coreIds[i]);
+        if (node < 0) {
+            continue;
+        }
+        oNodesLoad[node] += 100.0 - coresLoad.idle[i];
+        oNodesLoad[m_nodes.size() + node] += 1;
+    }
+    for (size_t node = 0; node < m_nodes.size(); ++node) {
+        const double coresCount = oNodesLoad[m_nodes.size() + node];
+        oNodesLoad[node] = coresCount > 0 ? oNodesLoad[node] / coresCount : 0;
+    }
+    oNodesLoad.resize(m_nodes.size());
+}
+
+bool NumaTopology::pinCurrentThread(size_t nodeIndex) const noexcept
+{
+    if (nodeIndex >= m_nodes.size() || m_nodes[nodeIndex].cpus.empty()) {
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : m_nodes[nodeIndex].cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    const int result = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (result != 0) {
+        COMPLOG_WARNING("Error pinning thread to NUMA node:", m_nodes[nodeIndex].id, std::strerror(result));
+        return false;
+    }
+    return true;
+}
+
+int NumaTopology::pciDeviceNode(const std::string &pciAddress, const std::string &pciRoot)
+{
+    std::string_view address = pciAddress;
+    if (address.substr(0, 4) == "pci@") {
+        address.remove_prefix(4);
+    }
+    if (address.empty()) {
+        return UNKNOWN_NODE;
+    }
+    return parseNode(readSmallFile(pciRoot + "/" + std::string(address) + "/numa_node"));
+}
+
+int NumaTopology::netDeviceNode(const std::string &interfaceName, const std::string &netRoot)
+{
+    if (interfaceName.empty()) {
+        return UNKNOWN_NODE;
+    }
+    return parseNode(readSmallFile(netRoot + "/" + interfaceName + "/device/numa_node"));
+}
+
+bool NumaTopology::parseCPUList(const std::string &cpuList, std::vector<uint32_t> &oCpus)
+{
+    oCpus.clear();
+    std::string_view text = cpuList;
+    while (!text.empty())
+    {
+        const auto commaPos = text.find(',');
+        const auto range = text.substr(0, commaPos);
+        text.remove_prefix(commaPos == std::string_view::npos ? text.size() : commaPos + 1);
+
+        uint32_t first {0}, last {0};
+        auto [ptr, ec] = std::from_chars(range.data(), range.data() + range.size(), first);
+        if (ec != std::errc()) {
+            return false;
+        }
+        last = first;
+        if (ptr != range.data() + range.size()) {
+            if (*ptr != '-' || std::from_chars(ptr + 1, range.data() + range.size(), last).ec != std::errc()) {
+                return false;
+            }
+        }
+        for (uint32_t cpu = first; cpu <= last; ++cpu) {
+            oCpus.push_back(cpu);
+        }
+    }
+    return true;
+}
+
+} // namespace SystemProcessing
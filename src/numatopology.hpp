@@ -0,0 +1,108 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <vector>
+
+namespace SystemProcessing {
+
+struct CPUCoresLoad;
+
+/**
+ * @brief The NumaNode struct  Узел NUMA: процессоры из nodeN/cpulist
+ */
+struct NumaNode
+{
+    int id {0};
+    std::vector<uint32_t> cpus;
+};
+
+/**
+ * @brief The NodeMemoryStats struct   Память узла из nodeN/meminfo. Размеры в байтах, HugePages_* — в страницах
+ */
+struct NodeMemoryStats
+{
+    uint64_t total {0};
+    uint64_t free {0};
+    uint64_t used {0};
+    uint64_t active {0};
+    uint64_t inactive {0};
+    uint64_t filePages {0};
+    uint64_t anonPages {0};
+    uint64_t shmem {0};
+    uint64_t slab {0};
+    uint64_t hugePagesTotal {0};
+    uint64_t hugePagesFree {0};
+};
+
+/**
+ * @brief The NumaTopology class   Топология NUMA из /sys/devices/system/node: какие процессоры на каком узле.
+ *                                 Файлы meminfo узлов открыты всё время жизни объекта.
+ *                                 Ядро без NUMA представляется одним узлом 0 со всеми процессорами
+ */
+class NumaTopology
+{
+public:
+    static constexpr int UNKNOWN_NODE = -1;
+
+    explicit NumaTopology(const std::string& nodeRoot = FsRoot::path("/sys/devices/system/node"));
+    ~NumaTopology();
+
+    NumaTopology(const NumaTopology&) = delete;
+    NumaTopology& operator=(const NumaTopology&) = delete;
+
+    const std::vector<NumaNode>& nodes() const noexcept;
+    size_t nodeCount() const noexcept;
+
+    /**
+     * @brief nodeIndex Индекс узла в nodes() по номеру процессора
+     * @return  -1, если процессор неизвестен
+     */
+    int nodeIndex(uint32_t cpu) const noexcept;
+
+    /**
+     * @brief readMemory    Прочитать память узла
+     * @param nodeIndex     Индекс в nodes()
+     * @return  false, если у узла нет meminfo
+     */
+    bool readMemory(size_t nodeIndex, NodeMemoryStats& oStats) const noexcept;
+
+    /**
+     * @brief aggregateLoad Средняя загруженность (100 - idle) процессоров каждого узла в процентах
+     * @param oNodesLoad    Результат по индексам nodes(). Узлы без данных получают 0
+     */
+    void aggregateLoad(const CPUCoresLoad& coresLoad, std::vector<double>& oNodesLoad) const;
+
+    /**
+     * @brief pinCurrentThread  Ограничить вызывающий поток процессорами узла
+     * @return  false, если узла нет или affinity не установить
+     */
+    bool pinCurrentThread(size_t nodeIndex) const noexcept;
+
+    /**
+     * @brief pciDeviceNode Узел PCI-устройства из numa_node
+     * @param pciAddress    Адрес вида "0000:03:00.0" (допускается префикс "pci@", как в lshw)
+     * @return  Номер узла или UNKNOWN_NODE, если платформа его не сообщает
+     */
+    static int pciDeviceNode(const std::string& pciAddress, const std::string& pciRoot = FsRoot::path("/sys/bus/pci/devices"));
+
+    /**
+     * @brief netDeviceNode Узел сетевого интерфейса (через его PCI-устройство)
+     */
+    static int netDeviceNode(const std::string& interfaceName, const std::string& netRoot = FsRoot::path("/sys/class/net"));
+
+    /**
+     * @brief parseCPUList  Разобрать список процессоров вида "0-3,8,10-11"
+     */
+    static bool parseCPUList(const std::string& cpuList, std::vector<uint32_t>& oCpus);
+
+private:
+    std::vector<NumaNode> m_nodes;
+    std::vector<int> m_meminfoFds;
+    std::vector<int> m_cpuNodeIndexes;  // Индекс узла по номеру процессора
+};
+
+} // namespace SystemProcessing
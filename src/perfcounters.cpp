@@ -0,0 +1,265 @@
+#include "perfcounters.hpp"
+#include "fsroot.hpp"
+#include "numatopology.hpp"
+#include "probestats.hpp"
+#include "sysutil.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+constexpr size_t GROUP_SIZE = 3;
+
+struct PerfEventId {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr PerfEventId SOFTWARE_EVENTS[GROUP_SIZE] {
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+};
+
+constexpr PerfEventId HARDWARE_EVENTS[GROUP_SIZE] {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+// PERF_FORMAT_GROUP with the enabled/running times: nr, time_enabled, time_running, values[nr]
+struct GroupReadFormat {
+    uint64_t count;
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+    uint64_t values[GROUP_SIZE];
+};
+
+int perfEventOpen(const PerfEventId& event, int pid, int cpu, int groupFd, unsigned long flags) noexcept
+{
+    perf_event_attr attr {};
+    attr.size        = sizeof(attr);
+    attr.type        = event.type;
+    attr.config      = event.config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_hv  = 1;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, pid, cpu, groupFd, flags | PERF_FLAG_FD_CLOEXEC));
+}
+
+/**
+ * Opens a whole group on one CPU; a group missing a member is closed so reads stay consistent
+ */
+int openGroup(const PerfEventId (&events)[GROUP_SIZE], int pid, int cpu, unsigned long flags, std::vector<int>& oFds) noexcept
+{
+    int groupFds[GROUP_SIZE] {-1, -1, -1};
+    for (size_t i = 0; i < GROUP_SIZE; ++i) {
+        groupFds[i] = perfEventOpen(events[i], pid, cpu, i == 0 ? -1 : groupFds[0], flags);
+        if (groupFds[i] < 0) {
+            const int error = errno;
+            for (size_t j = 0; j < i; ++j) {
+                ::close(groupFds[j]);
+            }
+            errno = error;
+            return -1;
+        }
+    }
+    oFds.insert(oFds.end(), groupFds, groupFds + GROUP_SIZE);
+    return groupFds[0];
+}
+
+bool readGroup(int leaderFd, uint64_t (&oValues)[GROUP_SIZE]) noexcept
+{
+    GroupReadFormat data;
+    if (::read(leaderFd, &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data.count != GROUP_SIZE) {
+        return false;
+    }
+
+    // Multiplexed with other users of the PMU: extrapolate to the whole enabled time
+    const bool isScaled = data.timeRunning != 0 && data.timeRunning < data.timeEnabled;
+    for (size_t i = 0; i < GROUP_SIZE; ++i) {
+        oValues[i] += isScaled ? static_cast<uint64_t>(double(data.values[i]) * data.timeEnabled / data.timeRunning)
+                               : data.values[i];
+    }
+    return true;
+}
+
+} // namespace
+
+PerfCounters::PerfCounters()
+{
+
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+bool PerfCounters::open(const std::string &cgroupPath)
+{
+    close();
+
+    std::vector<uint32_t> cpus;
+    if (!NumaTopology::parseCPUList(readSmallFile(FsRoot::path("/sys/devices/system/cpu/online")), cpus) || cpus.empty()) {
+        const auto cpusCount = ::sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < cpusCount; ++cpu) {
+            cpus.push_back(static_cast<uint32_t>(cpu));
+        }
+    }
+
+    // System-wide counters are per CPU with pid -1; a cgroup is passed as a directory fd in place of the pid
+    int pid = -1;
+    unsigned long flags = 0;
+    if (!cgroupPath.empty()) {
+        m_cgroupFd = ::open(cgroupPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (m_cgroupFd < 0) {
+            COMPLOG_WARNING("Error opening cgroup for perf counters:", cgroupPath);
+            return false;
+        }
+        pid = m_cgroupFd;
+        flags = PERF_FLAG_PID_CGROUP;
+    }
+
+    // Hardware groups are all or nothing: a sum over part of the CPUs would pass for a system-wide rate
+    std::vector<int> hardwareFds;
+    bool isHardwareAbsent = false;
+    for (auto cpu : cpus)
+    {
+        const int softwareLeader = openGroup(SOFTWARE_EVENTS, pid, static_cast<int>(cpu), flags, m_fds);
+        if (softwareLeader < 0) {
+            COMPLOG_WARNING("Error opening perf software counters on CPU", cpu, std::strerror(errno));
+            for (auto fd : hardwareFds) {
+                ::close(fd);
+            }
+            close();
+            return false;
+        }
+        m_softwareLeaders.push_back(softwareLeader);
+
+        if (isHardwareAbsent) {
+            continue;
+        }
+        const int hardwareLeader = openGroup(HARDWARE_EVENTS, pid, static_cast<int>(cpu), flags, hardwareFds);
+        if (hardwareLeader >= 0) {
+            m_hardwareLeaders.push_back(hardwareLeader);
+            continue;
+        }
+
+        if (errno == ENOENT || errno == EOPNOTSUPP || errno == ENODEV) {
+            // No PMU exposed (VMs, some containers)
+            COMPLOG_INFO("Hardware perf counters are not available, using software counters only");
+        } else {
+            COMPLOG_WARNING("Error opening perf hardware counters on CPU", cpu, std::strerror(errno),
+                            "- using software counters only");
+        }
+        for (auto fd : hardwareFds) {
+            ::close(fd);
+        }
+        hardwareFds.clear();
+        m_hardwareLeaders.clear();
+        isHardwareAbsent = true;
+    }
+    m_fds.insert(m_fds.end(), hardwareFds.begin(), hardwareFds.end());
+    return true;
+}
+
+void PerfCounters::close() noexcept
+{
+    for (auto fd : m_fds) {
+        ::close(fd);
+    }
+    m_fds.clear();
+    m_softwareLeaders.clear();
+    m_hardwareLeaders.clear();
+
+    if (m_cgroupFd >= 0) {
+        ::close(m_cgroupFd);
+        m_cgroupFd = -1;
+    }
+}
+
+bool PerfCounters::isOpened() const noexcept
+{
+    return !m_softwareLeaders.empty();
+}
+
+bool PerfCounters::hasHardware() const noexcept
+{
+    return !m_hardwareLeaders.empty();
+}
+
+bool PerfCounters::read(PerfCountersSample &oSample) const noexcept
+{
+    if (!isOpened()) {
+        return false;
+    }
+
+    SYSTEMPROCESSING_PROBE(probe, "perf.read");
+    oSample = {};
+    oSample.timestampNs = monotonicNs();
+
+    uint64_t softwareValues[GROUP_SIZE] {};
+    for (auto leaderFd : m_softwareLeaders) {
+        if (!readGroup(leaderFd, softwareValues)) {
+            probe.fail();
+            return false;
+        }
+    }
+    oSample.contextSwitches = softwareValues[0];
+    oSample.pageFaults      = softwareValues[1];
+    oSample.cpuMigrations   = softwareValues[2];
+
+    uint64_t hardwareValues[GROUP_SIZE] {};
+    oSample.hasHardware = !m_hardwareLeaders.empty();
+    for (auto leaderFd : m_hardwareLeaders) {
+        if (!readGroup(leaderFd, hardwareValues)) {
+            oSample.hasHardware = false;
+            break;
+        }
+    }
+    if (oSample.hasHardware) {
+        oSample.cycles       = hardwareValues[0];
+        oSample.instructions = hardwareValues[1];
+        oSample.cacheMisses  = hardwareValues[2];
+    }
+    probe.addBytes(sizeof(GroupReadFormat) * (m_softwareLeaders.size() + m_hardwareLeaders.size()));
+    return true;
+}
+
+PerfRates PerfCounters::rates(const PerfCountersSample &prev, const PerfCountersSample &cur) noexcept
+{
+    PerfRates result;
+    if (cur.timestampNs <= prev.timestampNs) {
+        return result;
+    }
+
+    const double elapsedSec = (cur.timestampNs - prev.timestampNs) / 1e9;
+    auto perSecond = [elapsedSec](uint64_t prevValue, uint64_t value) {
+        return value >= prevValue ? (value - prevValue) / elapsedSec : 0.0;
+    };
+    result.contextSwitchesPerSec = perSecond(prev.contextSwitches, cur.contextSwitches);
+    result.pageFaultsPerSec      = perSecond(prev.pageFaults, cur.pageFaults);
+    result.cpuMigrationsPerSec   = perSecond(prev.cpuMigrations, cur.cpuMigrations);
+
+    if (prev.hasHardware && cur.hasHardware) {
+        result.cacheMissesPerSec = perSecond(prev.cacheMisses, cur.cacheMisses);
+        if (cur.cycles > prev.cycles && cur.instructions >= prev.instructions) {
+            result.ipc = double(cur.instructions - prev.instructions) / (cur.cycles - prev.cycles);
+        }
+    }
+    return result;
+}
+
+} // namespace SystemProcessing
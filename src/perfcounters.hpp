@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The PerfCountersSample struct    Накопленные счётчики perf, суммированные по всем процессорам.
+ *                                         Аппаратные счётчики масштабированы на время работы при мультиплексировании
+ */
+struct PerfCountersSample
+{
+    uint64_t timestampNs {0};   // CLOCK_MONOTONIC
+
+    uint64_t contextSwitches {0};
+    uint64_t pageFaults {0};
+    uint64_t cpuMigrations {0};
+
+    bool hasHardware {false};   // Без PMU (большинство виртуальных машин) поля ниже нулевые
+    uint64_t cycles {0};
+    uint64_t instructions {0};
+    uint64_t cacheMisses {0};
+};
+
+/**
+ * @brief The PerfRates struct Производные величины между двумя замерами
+ */
+struct PerfRates
+{
+    double ipc {0};                     // Инструкции на такт, 0 без аппаратных счётчиков
+    double contextSwitchesPerSec {0};
+    double pageFaultsPerSec {0};
+    double cpuMigrationsPerSec {0};
+    double cacheMissesPerSec {0};
+};
+
+/**
+ * @brief The PerfCounters class   Счётчики perf_event_open по всей системе или по группе cgroup v2.
+ *                                 На каждом процессоре открываются две группы: программная (переключения контекста,
+ *                                 страничные ошибки, миграции) и аппаратная (такты, инструкции, промахи кэша),
+ *                                 так что один read() лидера возвращает всю группу.
+ *                                 Нужны CAP_PERFMON (или root) либо kernel.perf_event_paranoid <= 0
+ */
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief open  Открыть счётчики на всех процессорах
+     * @param cgroupPath    Полный путь каталога группы в /sys/fs/cgroup. Пустой — вся система
+     * @return  false, если не открылась даже программная группа (нет прав или ядро без perf)
+     */
+    bool open(const std::string& cgroupPath = {});
+    void close() noexcept;
+
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief hasHardware   Аппаратные счётчики открылись на всех процессорах. Если хоть на одном открыть не
+     *                      удалось, закрываются все, и в выборке остаются только программные счётчики
+     */
+    bool hasHardware() const noexcept;
+
+    bool read(PerfCountersSample& oSample) const noexcept;
+
+    static PerfRates rates(const PerfCountersSample& prev, const PerfCountersSample& cur) noexcept;
+
+private:
+    int m_cgroupFd {-1};
+    std::vector<int> m_fds;             // Все дескрипторы, для закрытия
+    std::vector<int> m_softwareLeaders;
+    std::vector<int> m_hardwareLeaders;
+};
+
+} // namespace SystemProcessing
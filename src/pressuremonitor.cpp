@@ -0,0 +1,327 @@
+#include "pressuremonitor.hpp"
+#include "fsroot.hpp"
+#include "probestats.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+constexpr const char* RESOURCE_NAMES[] {"cpu", "memory", "io"};
+
+constexpr size_t MAX_EVENTS = 16;
+
+// "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+bool parsePressureLine(std::string_view line, PressureStats& oStats) noexcept
+{
+    const auto parseValue = [&line](std::string_view key, auto& oValue) {
+        const auto keyPos = line.find(key);
+        if (keyPos == std::string_view::npos) {
+            return false;
+        }
+        const char* begin = line.data() + keyPos + key.size();
+        return std::from_chars(begin, line.data() + line.size(), oValue).ec == std::errc();
+    };
+
+    return parseValue("avg10=", oStats.avg10) &&
+           parseValue("avg60=", oStats.avg60) &&
+           parseValue("avg300=", oStats.avg300) &&
+           parseValue("total=", oStats.totalUs);
+}
+
+} // namespace
+
+PressureReader::PressureReader() :
+    PressureReader({systemFilePath(PressureResource::CPU),
+                    systemFilePath(PressureResource::Memory),
+                    systemFilePath(PressureResource::IO)})
+{
+
+}
+
+PressureReader::PressureReader(const std::array<std::string, 3> &paths)
+{
+    for (size_t i = 0; i < paths.size(); ++i) {
+        m_fds[i] = ::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+    }
+}
+
+PressureReader::~PressureReader()
+{
+    for (auto fd : m_fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+std::unique_ptr<PressureReader> PressureReader::forCgroup(const std::string &cgroupPath)
+{
+    return std::unique_ptr<PressureReader>(new PressureReader({
+        cgroupFilePath(cgroupPath, PressureResource::CPU),
+        cgroupFilePath(cgroupPath, PressureResource::Memory),
+        cgroupFilePath(cgroupPath, PressureResource::IO)}));
+}
+
+bool PressureReader::isAvailable(PressureResource resource) const noexcept
+{
+    return m_fds[static_cast<size_t>(resource)] >= 0;
+}
+
+bool PressureReader::read(PressureResource resource, PressureReading &oReading) const noexcept
+{
+    const int fd = m_fds[static_cast<size_t>(resource)];
+    if (fd < 0) {
+        return false;
+    }
+
+    char buffer[256];
+    SYSTEMPROCESSING_PROBE(probe, "psi.read");
+    const auto readBytes = ::pread(fd, buffer, sizeof(buffer), 0);
+    probe.addBytes(readBytes);
+    if (readBytes <= 0) {
+        probe.fail();
+        return false;
+    }
+
+    const std::string_view data(buffer, readBytes);
+    const auto lineEnd = data.find('\n');
+    if (data.substr(0, 4) != "some" || !parsePressureLine(data.substr(0, lineEnd), oReading.some)) {
+        return false;
+    }
+
+    oReading.hasFull = false;
+    if (lineEnd != std::string_view::npos) {
+        const auto fullLine = data.substr(lineEnd + 1);
+        oReading.hasFull = fullLine.substr(0, 4) == "full" && parsePressureLine(fullLine, oReading.full);
+    }
+    if (!oReading.hasFull) {
+        oReading.full = {};
+    }
+    return true;
+}
+
+std::string PressureReader::systemFilePath(PressureResource resource)
+{
+    return FsRoot::path("/proc/pressure/") + RESOURCE_NAMES[static_cast<size_t>(resource)];
+}
+
+std::string PressureReader::cgroupFilePath(const std::string &cgroupPath, PressureResource resource)
+{
+    return cgroupPath + "/" + RESOURCE_NAMES[static_cast<size_t>(resource)] + ".pressure";
+}
+
+struct PressureMonitor::PressureMonitorPrivate
+{
+    struct TriggerEntry
+    {
+        int fd {-1};
+        PressureTrigger trigger;
+        Callback callback;
+    };
+
+    int epollFd {epoll_create1(EPOLL_CLOEXEC)};
+    int wakeFd {eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+
+    std::mutex triggersMx;
+    std::map<int, std::shared_ptr<TriggerEntry>> triggers;
+    int nextTriggerId {1};
+
+    std::thread monitorThread;
+    std::atomic<bool> stopRequested {false};
+
+    PressureMonitorPrivate()
+    {
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.u64 = 0; // Trigger ids start from 1
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    }
+
+    ~PressureMonitorPrivate()
+    {
+        stopThread();
+        for (auto& [id, pEntry] : triggers) {
+            ::close(pEntry->fd);
+        }
+        ::close(wakeFd);
+        ::close(epollFd);
+    }
+
+    void stopThread()
+    {
+        if (!monitorThread.joinable()) {
+            return;
+        }
+        stopRequested = true;
+        const uint64_t wakeValue = 1;
+        if (::write(wakeFd, &wakeValue, sizeof(wakeValue)) < 0) {
+            COMPLOG_WARNING("Error waking PSI monitor thread");
+        }
+        monitorThread.join();
+
+        uint64_t drainValue {};
+        while (::read(wakeFd, &drainValue, sizeof(drainValue)) > 0) {}
+        stopRequested = false;
+    }
+
+    int waitEvents(int timeoutMs)
+    {
+        epoll_event events[MAX_EVENTS];
+        const int eventCount = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+        if (eventCount < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+
+        int fired = 0;
+        for (int i = 0; i < eventCount; ++i)
+        {
+            const int triggerId = static_cast<int>(events[i].data.u64);
+            if (triggerId == 0) {
+                continue;
+            }
+
+            std::shared_ptr<TriggerEntry> pEntry;
+            {
+                std::lock_guard lock(triggersMx);
+                auto triggerIt = triggers.find(triggerId);
+                if (triggerIt == triggers.end()) {
+                    continue;
+                }
+                pEntry = triggerIt->second;
+            }
+
+            // The monitored file is gone (e.g. the cgroup was removed)
+            if (events[i].events & EPOLLERR) {
+                COMPLOG_WARNING("PSI trigger source is gone:", pEntry->trigger.filePath);
+                removeTrigger(triggerId);
+                continue;
+            }
+
+            if (events[i].events & EPOLLPRI) {
+                pEntry->callback(triggerId, pEntry->trigger);
+                fired++;
+            }
+        }
+        return fired;
+    }
+
+    void monitorLoop()
+    {
+        while (!stopRequested) {
+            if (waitEvents(-1) < 0) {
+                COMPLOG_ERROR("PSI monitor wait failed:", strerror(errno));
+                return;
+            }
+        }
+    }
+
+    bool removeTrigger(int triggerId)
+    {
+        std::lock_guard lock(triggersMx);
+        auto triggerIt = triggers.find(triggerId);
+        if (triggerIt == triggers.end()) {
+            return false;
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, triggerIt->second->fd, nullptr);
+        ::close(triggerIt->second->fd);
+        triggers.erase(triggerIt);
+        return true;
+    }
+};
+
+PressureMonitor::PressureMonitor() :
+    d {new PressureMonitorPrivate}
+{
+
+}
+
+PressureMonitor::~PressureMonitor()
+{
+
+}
+
+int PressureMonitor::addTrigger(const PressureTrigger &trigger, Callback callback)
+{
+    const int fd = ::open(trigger.filePath.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        COMPLOG_WARNING("Error opening PSI file:", trigger.filePath, strerror(errno));
+        return -1;
+    }
+
+    // The kernel expects "<some|full> <stall us> <window us>" including the terminating zero
+    char triggerText[64];
+    const int textSize = std::snprintf(triggerText, sizeof(triggerText), "%s %lld %lld",
+                                       trigger.full ? "full" : "some",
+                                       static_cast<long long>(trigger.stall.count()),
+                                       static_cast<long long>(trigger.window.count()));
+    if (::write(fd, triggerText, textSize + 1) < 0) {
+        COMPLOG_WARNING("Error registering PSI trigger:", trigger.filePath, triggerText, strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+
+    auto pEntry = std::make_shared<PressureMonitorPrivate::TriggerEntry>();
+    pEntry->fd = fd;
+    pEntry->trigger = trigger;
+    pEntry->callback = std::move(callback);
+
+    std::lock_guard lock(d->triggersMx);
+    const int triggerId = d->nextTriggerId++;
+
+    epoll_event event {};
+    event.events = EPOLLPRI;
+    event.data.u64 = triggerId;
+    if (epoll_ctl(d->epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        COMPLOG_WARNING("Error adding PSI trigger to epoll:", strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+
+    d->triggers.emplace(triggerId, std::move(pEntry));
+    return triggerId;
+}
+
+bool PressureMonitor::removeTrigger(int triggerId)
+{
+    return d->removeTrigger(triggerId);
+}
+
+bool PressureMonitor::start()
+{
+    if (d->monitorThread.joinable()) {
+        return true;
+    }
+    if (d->epollFd < 0 || d->wakeFd < 0) {
+        return false;
+    }
+    d->monitorThread = std::thread(&PressureMonitorPrivate::monitorLoop, d.get());
+    return true;
+}
+
+void PressureMonitor::stop()
+{
+    d->stopThread();
+}
+
+int PressureMonitor::poll(std::chrono::milliseconds timeout)
+{
+    return d->waitEvents(static_cast<int>(timeout.count()));
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace SystemProcessing {
+
+enum class PressureResource : uint8_t {
+    CPU,
+    Memory,
+    IO
+};
+
+/**
+ * @brief The PressureStats struct Одна строка PSI (some или full)
+ */
+struct PressureStats
+{
+    double avg10 {0};   // Проценты
+    double avg60 {0};
+    double avg300 {0};
+    uint64_t totalUs {0};
+};
+
+struct PressureReading
+{
+    PressureStats some;
+    PressureStats full;
+    bool hasFull {false};   // Для CPU на системном уровне строка full есть только в новых ядрах
+};
+
+/**
+ * @brief The PressureReader class Чтение Pressure Stall Information (/proc/pressure или *.pressure в cgroup v2).
+ *                                  Файлы открываются один раз и перечитываются через pread
+ */
+class PressureReader
+{
+public:
+    /**
+     * @brief PressureReader    Системный PSI из /proc/pressure/{cpu,memory,io}
+     */
+    PressureReader();
+    ~PressureReader();
+
+    PressureReader(const PressureReader&) = delete;
+    PressureReader& operator=(const PressureReader&) = delete;
+
+    /**
+     * @brief forCgroup     PSI группы cgroup v2 из {cpu,memory,io}.pressure
+     * @param cgroupPath    Полный путь до каталога группы в /sys/fs/cgroup
+     */
+    static std::unique_ptr<PressureReader> forCgroup(const std::string& cgroupPath);
+
+    bool isAvailable(PressureResource resource) const noexcept;
+
+    /**
+     * @brief read  Прочитать PSI ресурса
+     * @return  false, если файл недоступен (ядро без CONFIG_PSI)
+     */
+    bool read(PressureResource resource, PressureReading& oReading) const noexcept;
+
+    static std::string systemFilePath(PressureResource resource);
+    static std::string cgroupFilePath(const std::string& cgroupPath, PressureResource resource);
+
+private:
+    std::array<int, 3> m_fds {-1, -1, -1};
+
+    explicit PressureReader(const std::array<std::string, 3>& paths);
+};
+
+/**
+ * @brief The PressureTrigger struct   Порог PSI: уведомление, если за окно window задержка превысила stall
+ */
+struct PressureTrigger
+{
+    std::string filePath;           // Файл PSI (системный или *.pressure группы)
+    bool full {false};              // Порог на строку full, иначе some
+    std::chrono::microseconds stall {150000};
+    std::chrono::microseconds window {1000000};
+};
+
+/**
+ * @brief The PressureMonitor class    Уведомления о превышении порогов PSI без опроса: триггеры регистрируются в ядре,
+ *                                      поток ждёт их через epoll и вызывает обработчики
+ */
+class PressureMonitor
+{
+public:
+    using Callback = std::function<void(int triggerId, const PressureTrigger& trigger)>;
+
+    PressureMonitor();
+    ~PressureMonitor();
+
+    PressureMonitor(const PressureMonitor&) = delete;
+    PressureMonitor& operator=(const PressureMonitor&) = delete;
+
+    /**
+     * @brief addTrigger    Зарегистрировать порог. Можно вызывать при запущенном мониторе
+     * @return  Идентификатор триггера или -1 при ошибке (нет прав, неверное окно и т.п.)
+     */
+    int addTrigger(const PressureTrigger& trigger, Callback callback);
+    bool removeTrigger(int triggerId);
+
+    /**
+     * @brief start Запустить поток ожидания событий
+     */
+    bool start();
+    void stop();
+
+    /**
+     * @brief poll  Обработать события в вызывающем потоке (без start())
+     * @param timeout   Максимальное время ожидания, -1 — без ограничения
+     * @return  Число сработавших триггеров или -1 при ошибке
+     */
+    int poll(std::chrono::milliseconds timeout);
+
+private:
+    struct PressureMonitorPrivate;
+    std::shared_ptr<PressureMonitorPrivate> d;
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,133 @@
+#include "probestats.hpp"
+
+namespace SystemProcessing {
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::count() const noexcept
+{
+    uint64_t result = 0;
+    for (auto& bucket : m_buckets) {
+        result += bucket.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const noexcept
+{
+    // Buckets are copied first: writers keep going while the summary is built
+    uint64_t counts[BUCKETS_COUNT];
+    uint64_t total = 0;
+    for (unsigned i = 0; i < BUCKETS_COUNT; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    q = q < 0 ? 0 : (q > 1 ? 1 : q);
+    const uint64_t rank = static_cast<uint64_t>(q * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < BUCKETS_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return (bucketLowerBound(i) + bucketUpperBound(i)) / 2;
+        }
+    }
+    return bucketUpperBound(BUCKETS_COUNT - 1);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(unsigned index) noexcept
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const unsigned exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    const uint64_t subBucket = index % SUB_BUCKETS;
+    return (SUB_BUCKETS + subBucket) << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(unsigned index) noexcept
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const unsigned exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    return bucketLowerBound(index) + (uint64_t(1) << (exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+ProbeStats::ProbeStats(std::string_view name) :
+    m_name {name}
+{
+
+}
+
+ProbeSummary ProbeStats::summary() const
+{
+    ProbeSummary result;
+    result.name         = m_name;
+    result.calls        = m_calls.load(std::memory_order_relaxed);
+    result.failures     = m_failures.load(std::memory_order_relaxed);
+    result.bytesRead    = m_bytesRead.load(std::memory_order_relaxed);
+    result.subprocesses = m_subprocesses.load(std::memory_order_relaxed);
+    result.totalNs      = m_totalNs.load(std::memory_order_relaxed);
+    result.maxNs        = m_maxNs.load(std::memory_order_relaxed);
+    result.p50Ns        = m_latency.percentile(0.5);
+    result.p90Ns        = m_latency.percentile(0.9);
+    result.p99Ns        = m_latency.percentile(0.99);
+    return result;
+}
+
+void ProbeStats::reset() noexcept
+{
+    m_calls.store(0, std::memory_order_relaxed);
+    m_failures.store(0, std::memory_order_relaxed);
+    m_bytesRead.store(0, std::memory_order_relaxed);
+    m_subprocesses.store(0, std::memory_order_relaxed);
+    m_totalNs.store(0, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+    m_latency.reset();
+}
+
+ProbeRegistry &ProbeRegistry::getInstance()
+{
+    static ProbeRegistry instance;
+    return instance;
+}
+
+ProbeStats &ProbeRegistry::probe(std::string_view name)
+{
+    std::lock_guard lock(m_mx);
+    for (auto& probe : m_probes) {
+        if (probe.name() == name) {
+            return probe;
+        }
+    }
+    return m_probes.emplace_back(name);
+}
+
+void ProbeRegistry::summaries(std::vector<ProbeSummary> &oSummaries) const
+{
+    std::lock_guard lock(m_mx);
+    oSummaries.clear();
+    oSummaries.reserve(m_probes.size());
+    for (auto& probe : m_probes) {
+        oSummaries.push_back(probe.summary());
+    }
+}
+
+void ProbeRegistry::reset() noexcept
+{
+    std::lock_guard lock(m_mx);
+    for (auto& probe : m_probes) {
+        probe.reset();
+    }
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "tracerecorder.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The LatencyHistogram class   Гистограмма задержек в наносекундах с логарифмическими корзинами (как HDR):
+ *                                     8 корзин на каждую степень двойки, погрешность не больше 12.5%.
+ *                                     Запись — один relaxed fetch_add, без блокировок
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 47;    // 2^47 нс — около 39 часов
+    static constexpr unsigned BUCKETS_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    void record(uint64_t valueNs) noexcept
+    {
+        m_buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void reset() noexcept;
+    uint64_t count() const noexcept;
+
+    /**
+     * @brief percentile    Значение квантиля q (0..1) — середина корзины, в которую он попал
+     */
+    uint64_t percentile(double q) const noexcept;
+
+    static unsigned bucketIndex(uint64_t valueNs) noexcept
+    {
+        if (valueNs < SUB_BUCKETS) {
+            return static_cast<unsigned>(valueNs);
+        }
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(valueNs));
+        if (exponent > MAX_EXPONENT) {
+            return BUCKETS_COUNT - 1;
+        }
+        const unsigned subBucket = static_cast<unsigned>(valueNs >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+    }
+
+    static uint64_t bucketLowerBound(unsigned index) noexcept;
+    static uint64_t bucketUpperBound(unsigned index) noexcept;
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKETS_COUNT] {};
+};
+
+/**
+ * @brief The ProbeSummary struct  Сводка по пробе для API
+ */
+struct ProbeSummary
+{
+    std::string name;
+    uint64_t calls {0};
+    uint64_t failures {0};
+    uint64_t bytesRead {0};
+    uint64_t subprocesses {0};  // Запущенные процессы (awk, smartctl, curl...)
+    uint64_t totalNs {0};
+    uint64_t maxNs {0};
+    uint64_t p50Ns {0};
+    uint64_t p90Ns {0};
+    uint64_t p99Ns {0};
+};
+
+/**
+ * @brief The ProbeStats class Счётчики и гистограмма задержек одной пробы (чтение файла, запуск утилиты...)
+ */
+class ProbeStats
+{
+public:
+    explicit ProbeStats(std::string_view name);
+
+    const std::string& name() const noexcept { return m_name; }
+
+    void record(uint64_t durationNs, bool isSuccess, uint64_t bytesRead, uint32_t subprocesses) noexcept
+    {
+        m_calls.fetch_add(1, std::memory_order_relaxed);
+        m_totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+        if (!isSuccess) {
+            m_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (bytesRead != 0) {
+            m_bytesRead.fetch_add(bytesRead, std::memory_order_relaxed);
+        }
+        if (subprocesses != 0) {
+            m_subprocesses.fetch_add(subprocesses, std::memory_order_relaxed);
+        }
+
+        auto maxNs = m_maxNs.load(std::memory_order_relaxed);
+        while (durationNs > maxNs && !m_maxNs.compare_exchange_weak(maxNs, durationNs, std::memory_order_relaxed));
+
+        m_latency.record(durationNs);
+    }
+
+    ProbeSummary summary() const;
+    const LatencyHistogram& latency() const noexcept { return m_latency; }
+    void reset() noexcept;
+
+private:
+    std::string m_name;
+    std::atomic<uint64_t> m_calls {0};
+    std::atomic<uint64_t> m_failures {0};
+    std::atomic<uint64_t> m_bytesRead {0};
+    std::atomic<uint64_t> m_subprocesses {0};
+    std::atomic<uint64_t> m_totalNs {0};
+    std::atomic<uint64_t> m_maxNs {0};
+    LatencyHistogram m_latency;
+};
+
+/**
+ * @brief The ProbeRegistry class  Все пробы процесса. Проба регистрируется один раз по имени,
+ *                                 ссылка на неё остаётся действительной до конца работы
+ */
+class ProbeRegistry
+{
+public:
+    static ProbeRegistry& getInstance();
+
+    /**
+     * @brief probe Найти или создать пробу. Для горячего пути ссылку сохраняют в static (см. SYSTEMPROCESSING_PROBE)
+     */
+    ProbeStats& probe(std::string_view name);
+
+    void summaries(std::vector<ProbeSummary>& oSummaries) const;
+    void reset() noexcept;
+
+    /**
+     * @brief setEnabled    Включить или выключить замеры во время работы. Выключенная проба стоит одну загрузку флага
+     */
+    static void setEnabled(bool isEnabled) noexcept { s_isEnabled.store(isEnabled, std::memory_order_relaxed); }
+    static bool isEnabled() noexcept { return s_isEnabled.load(std::memory_order_relaxed); }
+
+private:
+    ProbeRegistry() = default;
+
+    mutable std::mutex m_mx;
+    std::deque<ProbeStats> m_probes;    // deque: адреса не меняются при добавлении
+
+    static inline std::atomic<bool> s_isEnabled {true};
+};
+
+/**
+ * @brief The ProbeScope class Замер одного вызова пробы: время от создания до разрушения объекта.
+ *                             При включённом TraceRecorder вызов попадает и в трассу
+ */
+class ProbeScope
+{
+public:
+#if SYSTEMPROCESSING_PROBES
+    explicit ProbeScope(ProbeStats& probe) noexcept :
+        m_pProbe {ProbeRegistry::isEnabled() || TraceRecorder::isEnabled() ? &probe : nullptr}
+    {
+        if (m_pProbe != nullptr) {
+            m_startNs = monotonicNs();
+        }
+    }
+
+    ~ProbeScope()
+    {
+        if (m_pProbe == nullptr) {
+            return;
+        }
+        const auto durationNs = monotonicNs() - m_startNs;
+        if (ProbeRegistry::isEnabled()) {
+            m_pProbe->record(durationNs, !m_isFailed, m_bytesRead, m_subprocesses);
+        }
+        if (TraceRecorder::isEnabled()) {
+            TraceRecorder::getInstance().record(m_pProbe->name().c_str(), m_startNs, durationNs);
+        }
+    }
+
+    void fail() noexcept { m_isFailed = true; }
+    void addBytes(int64_t bytes) noexcept { m_bytesRead += bytes > 0 ? static_cast<uint64_t>(bytes) : 0; }
+    void addSubprocess() noexcept { ++m_subprocesses; }
+
+private:
+    ProbeStats* m_pProbe {nullptr};
+    uint64_t m_startNs {0};
+    uint64_t m_bytesRead {0};
+    uint32_t m_subprocesses {0};
+    bool m_isFailed {false};
+#else
+    explicit ProbeScope(ProbeStats&) noexcept {}
+
+    void fail() noexcept {}
+    void addBytes(int64_t) noexcept {}
+    void addSubprocess() noexcept {}
+#endif // SYSTEMPROCESSING_PROBES
+
+public:
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+};
+
+} // namespace SystemProcessing
+
+/**
+ * @brief SYSTEMPROCESSING_PROBE   Объявить замер scopeName пробы probeName до конца блока.
+ *                                 Поиск пробы по имени выполняется только при первом проходе
+ */
+#define SYSTEMPROCESSING_PROBE(scopeName, probeName) \
+    static auto& scopeName##Stats = ::SystemProcessing::ProbeRegistry::getInstance().probe(probeName); \
+    ::SystemProcessing::ProbeScope scopeName(scopeName##Stats)
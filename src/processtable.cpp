@@ -0,0 +1,454 @@
+#include "processtable.hpp"
+#include "dirfdbudget.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Entries processed by a worker at once
+constexpr size_t READ_CHUNK_SIZE = 128;
+
+struct ProcessEntry
+{
+    ProcessUsage usage;
+    int dirFd {-1};
+    uint64_t prevCpuTicks {0};
+    bool hasPrevious {false};
+    bool alive {true};
+    uint64_t seenGeneration {0};
+};
+
+// Persistent threads that run the same job over shared work until it's exhausted
+class WorkerPool
+{
+public:
+    explicit WorkerPool(size_t workerCount)
+    {
+        for (size_t i = 0; i < workerCount; ++i) {
+            m_threads.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard lock(m_mx);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    // The calling thread takes part in the job too
+    void run(const std::function<void()>& job)
+    {
+        {
+            std::lock_guard lock(m_mx);
+            m_job = &job;
+            m_pending = m_threads.size();
+            m_generation++;
+        }
+        m_cv.notify_all();
+
+        job();
+
+        std::unique_lock lock(m_mx);
+        m_doneCv.wait(lock, [this]() { return m_pending == 0; });
+        m_job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mx;
+    std::condition_variable m_cv;
+    std::condition_variable m_doneCv;
+    const std::function<void()>* m_job {nullptr};
+    uint64_t m_generation {0};
+    size_t m_pending {0};
+    bool m_stop {false};
+
+    void workerLoop()
+    {
+        uint64_t doneGeneration = 0;
+        std::unique_lock lock(m_mx);
+        while (true)
+        {
+            m_cv.wait(lock, [&]() { return m_stop || m_generation != doneGeneration; });
+            if (m_stop) {
+                return;
+            }
+            doneGeneration = m_generation;
+            auto pJob = m_job;
+
+            lock.unlock();
+            (*pJob)();
+            lock.lock();
+
+            if (--m_pending == 0) {
+                m_doneCv.notify_one();
+            }
+        }
+    }
+};
+
+bool parsePid(const char* name, pid_t& oPid) noexcept
+{
+    const char* end = name + std::strlen(name);
+    auto [ptr, ec] = std::from_chars(name, end, oPid);
+    return ec == std::errc() && ptr == end;
+}
+
+const char* skipFields(const char* pos, const char* end, size_t count) noexcept
+{
+    for (size_t i = 0; i < count && pos < end; ++i) {
+        pos = static_cast<const char*>(std::memchr(pos, ' ', end - pos));
+        if (pos == nullptr) {
+            return end;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+// Reads the whole small procfs file into the buffer, returns its size or -1
+ssize_t readProcFile(int dirFd, const char* procRoot, pid_t pid, const char* fileName, char* buffer, size_t bufferSize) noexcept
+{
+    int fd = -1;
+    if (dirFd >= 0) {
+        fd = openat(dirFd, fileName, O_RDONLY | O_CLOEXEC);
+    } else {
+        char path[64];
+        std::snprintf(path, sizeof(path), "%s/%d/%s", procRoot, pid, fileName);
+        fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0) {
+        return -1;
+    }
+
+    const auto readBytes = ::read(fd, buffer, bufferSize - 1);
+    ::close(fd);
+    return readBytes;
+}
+
+// /proc/[pid]/stat: pid (comm) state ppid ... utime(14) stime(15) ... starttime(22)
+bool parseStat(const char* buffer, size_t size, ProcessUsage& oUsage) noexcept
+{
+    const char* end = buffer + size;
+    auto commBegin = static_cast<const char*>(std::memchr(buffer, '(', size));
+    auto commEnd = static_cast<const char*>(memrchr(buffer, ')', size));
+    if (commBegin == nullptr || commEnd == nullptr || commEnd < commBegin || commEnd + 2 >= end) {
+        return false;
+    }
+
+    const size_t commSize = std::min<size_t>(commEnd - commBegin - 1, sizeof(oUsage.comm) - 1);
+    std::memcpy(oUsage.comm, commBegin + 1, commSize);
+    oUsage.comm[commSize] = '\0';
+
+    // Fields after the comm start with the state (field 3)
+    const char* pos = skipFields(commEnd + 2, end, 14 - 3);
+    uint64_t utime {}, stime {};
+    auto res = std::from_chars(pos, end, utime);
+    if (res.ec != std::errc()) {
+        return false;
+    }
+    res = std::from_chars(res.ptr + 1, end, stime);
+    if (res.ec != std::errc()) {
+        return false;
+    }
+    pos = skipFields(res.ptr + 1, end, 22 - 16);
+    if (std::from_chars(pos, end, oUsage.startTime).ec != std::errc()) {
+        return false;
+    }
+
+    oUsage.cpuTicks = utime + stime;
+    return true;
+}
+
+} // namespace
+
+struct ProcessTable::ProcessTablePrivate
+{
+    std::string procRoot;
+    DIR* procDir {nullptr};
+
+    std::vector<ProcessEntry> entries;
+    std::unordered_map<pid_t, size_t> entryIndexes;
+    uint64_t scanGeneration {0};
+
+    std::chrono::steady_clock::time_point lastUpdate;
+    const long clockTicks {sysconf(_SC_CLK_TCK)};
+    const long pageSize {sysconf(_SC_PAGESIZE)};
+
+    WorkerPool workers;
+    std::atomic<size_t> nextChunk {0};
+    double elapsedTicks {0};
+
+    ProcessTablePrivate(size_t workerCount, const std::string& root) :
+        procRoot {root},
+        procDir {opendir(root.c_str())},
+        workers {workerCount}
+    {
+
+    }
+
+    ~ProcessTablePrivate()
+    {
+        for (auto& entry : entries) {
+            closeEntry(entry);
+        }
+        if (procDir != nullptr) {
+            closedir(procDir);
+        }
+    }
+
+    static void closeEntry(ProcessEntry& entry) noexcept
+    {
+        if (entry.dirFd >= 0) {
+            ::close(entry.dirFd);
+            DirFdBudget::release();
+            entry.dirFd = -1;
+        }
+    }
+
+    int openProcessDir(pid_t pid) const noexcept
+    {
+        // Past the shared budget or on failure the entry is read by absolute paths
+        if (!DirFdBudget::tryAcquire()) {
+            return -1;
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "%d", pid);
+        const int dirFd = openat(dirfd(procDir), name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd < 0) {
+            DirFdBudget::release();
+        }
+        return dirFd;
+    }
+
+    bool readEntryFiles(ProcessEntry& entry) const noexcept
+    {
+        char buffer[1024];
+        auto readBytes = readProcFile(entry.dirFd, procRoot.c_str(), entry.usage.pid, "stat", buffer, sizeof(buffer));
+        if (readBytes <= 0 || !parseStat(buffer, readBytes, entry.usage)) {
+            return false;
+        }
+
+        readBytes = readProcFile(entry.dirFd, procRoot.c_str(), entry.usage.pid, "statm", buffer, sizeof(buffer));
+        if (readBytes <= 0) {
+            return false;
+        }
+        // size resident shared ...
+        const char* end = buffer + readBytes;
+        const char* pos = skipFields(buffer, end, 1);
+        uint64_t residentPages {};
+        if (std::from_chars(pos, end, residentPages).ec != std::errc()) {
+            return false;
+        }
+        entry.usage.rssBytes = residentPages * pageSize;
+        return true;
+    }
+
+    void readEntry(ProcessEntry& entry) const noexcept
+    {
+        const auto prevStartTime = entry.usage.startTime;
+        if (!readEntryFiles(entry)) {
+            // The directory fd may belong to a dead process whose PID was reused
+            if (entry.dirFd < 0) {
+                entry.alive = false;
+                return;
+            }
+            closeEntry(entry);
+            entry.dirFd = openProcessDir(entry.usage.pid);
+            if (!readEntryFiles(entry)) {
+                entry.alive = false;
+                return;
+            }
+        }
+
+        if (entry.hasPrevious && entry.usage.startTime != prevStartTime) {
+            entry.hasPrevious = false;
+        }
+
+        if (entry.hasPrevious && elapsedTicks > 0) {
+            const auto ticksDelta = entry.usage.cpuTicks - entry.prevCpuTicks;
+            entry.usage.cpuPercent = 100.0 * ticksDelta / elapsedTicks;
+        } else {
+            entry.usage.cpuPercent = 0;
+        }
+        entry.prevCpuTicks = entry.usage.cpuTicks;
+        entry.hasPrevious = true;
+    }
+
+    void removeEntry(size_t pos)
+    {
+        closeEntry(entries[pos]);
+        entryIndexes.erase(entries[pos].usage.pid);
+        if (pos != entries.size() - 1) {
+            entries[pos] = entries.back();
+            entryIndexes[entries[pos].usage.pid] = pos;
+        }
+        entries.pop_back();
+    }
+
+    template<typename Predicate>
+    void removeEntriesIf(Predicate&& predicate)
+    {
+        for (size_t pos = 0; pos < entries.size();) {
+            if (predicate(entries[pos])) {
+                removeEntry(pos);
+            } else {
+                ++pos;
+            }
+        }
+    }
+
+    void scanPids()
+    {
+        scanGeneration++;
+        rewinddir(procDir);
+        while (auto dirEntry = readdir(procDir))
+        {
+            pid_t pid {};
+            if (!parsePid(dirEntry->d_name, pid)) {
+                continue;
+            }
+
+            auto indexIt = entryIndexes.find(pid);
+            if (indexIt != entryIndexes.end()) {
+                entries[indexIt->second].seenGeneration = scanGeneration;
+                continue;
+            }
+
+            ProcessEntry entry;
+            entry.usage.pid = pid;
+            entry.dirFd = openProcessDir(pid);
+            entry.seenGeneration = scanGeneration;
+            entryIndexes.emplace(pid, entries.size());
+            entries.push_back(entry);
+        }
+
+        removeEntriesIf([this](const ProcessEntry& entry) { return entry.seenGeneration != scanGeneration; });
+    }
+
+    void readEntries()
+    {
+        nextChunk.store(0, std::memory_order_relaxed);
+        const std::function<void()> job = [this]() {
+            while (true)
+            {
+                const size_t begin = nextChunk.fetch_add(READ_CHUNK_SIZE, std::memory_order_relaxed);
+                if (begin >= entries.size()) {
+                    return;
+                }
+                const size_t end = std::min(begin + READ_CHUNK_SIZE, entries.size());
+                for (size_t pos = begin; pos < end; ++pos) {
+                    readEntry(entries[pos]);
+                }
+            }
+        };
+        workers.run(job);
+
+        removeEntriesIf([](const ProcessEntry& entry) { return !entry.alive; });
+    }
+
+    template<typename Key>
+    size_t top(ProcessUsage* oTop, size_t count, Key&& key) const
+    {
+        // Min-heap of the best count entries, the smallest is replaced
+        const auto greater = [&key](const ProcessUsage& left, const ProcessUsage& right) {
+            return key(left) > key(right);
+        };
+
+        size_t size = 0;
+        for (auto& entry : entries) {
+            if (size < count) {
+                oTop[size++] = entry.usage;
+                std::push_heap(oTop, oTop + size, greater);
+            } else if (count && key(entry.usage) > key(oTop[0])) {
+                std::pop_heap(oTop, oTop + size, greater);
+                oTop[size - 1] = entry.usage;
+                std::push_heap(oTop, oTop + size, greater);
+            }
+        }
+        std::sort_heap(oTop, oTop + size, greater);
+        return size;
+    }
+};
+
+ProcessTable::ProcessTable(size_t workerCount, const std::string &procRoot) :
+    d {new ProcessTablePrivate(workerCount, procRoot)}
+{
+    if (d->procDir == nullptr) {
+        COMPLOG_ERROR("Error opening proc directory:", procRoot);
+    }
+}
+
+ProcessTable::~ProcessTable()
+{
+
+}
+
+bool ProcessTable::update()
+{
+    if (d->procDir == nullptr) {
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    d->elapsedTicks = d->lastUpdate.time_since_epoch().count()
+            ? std::chrono::duration<double>(now - d->lastUpdate).count() * d->clockTicks
+            : 0;
+    d->lastUpdate = now;
+
+    d->scanPids();
+    d->readEntries();
+    return true;
+}
+
+size_t ProcessTable::processCount() const noexcept
+{
+    return d->entries.size();
+}
+
+size_t ProcessTable::topByCPU(ProcessUsage *oTop, size_t count) const
+{
+    return d->top(oTop, count, [](const ProcessUsage& usage) { return usage.cpuPercent; });
+}
+
+size_t ProcessTable::topByMemory(ProcessUsage *oTop, size_t count) const
+{
+    return d->top(oTop, count, [](const ProcessUsage& usage) { return usage.rssBytes; });
+}
+
+bool ProcessTable::find(pid_t pid, ProcessUsage &oUsage) const
+{
+    auto indexIt = d->entryIndexes.find(pid);
+    if (indexIt == d->entryIndexes.end()) {
+        return false;
+    }
+    oUsage = d->entries[indexIt->second].usage;
+    return true;
+}
+
+} // namespace SystemProcessing
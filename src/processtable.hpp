@@ -0,0 +1,77 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The ProcessUsage struct  Потребление ресурсов одним процессом
+ */
+struct ProcessUsage
+{
+    pid_t pid {0};
+    char comm[16] {};       // Имя из /proc/[pid]/stat
+    double cpuPercent {0};  // Процент одного ядра за интервал между update(), как в top
+    uint64_t rssBytes {0};
+    uint64_t cpuTicks {0};  // utime + stime
+    uint64_t startTime {0}; // В тиках от загрузки
+};
+
+/**
+ * @brief The ProcessTable class   Учёт CPU и памяти всех процессов по /proc/[pid]/stat и statm.
+ *                                  Каталоги процессов остаются открытыми между обновлениями в пределах DirFdBudget
+ *                                  (остальные читаются по пути), чтение делится
+ *                                  между несколькими потоками, переиспользование PID определяется по starttime.
+ *                                  Не потокобезопасен
+ */
+class ProcessTable
+{
+public:
+    /**
+     * @brief ProcessTable  Создать таблицу
+     * @param workerCount   Потоков для чтения /proc. 0 — читать в вызывающем потоке
+     */
+    explicit ProcessTable(size_t workerCount = 4, const std::string& procRoot = FsRoot::path("/proc"));
+    ~ProcessTable();
+
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+
+    /**
+     * @brief update    Пересканировать процессы и пересчитать загрузку с предыдущего вызова
+     * @return  false, если каталог /proc не читается
+     */
+    bool update();
+
+    size_t processCount() const noexcept;
+
+    /**
+     * @brief topByCPU  Процессы с наибольшей загрузкой CPU, по убыванию
+     * @param oTop      Буфер минимум на count элементов
+     * @return  Число заполненных элементов
+     */
+    size_t topByCPU(ProcessUsage* oTop, size_t count) const;
+
+    /**
+     * @brief topByMemory   Процессы с наибольшим RSS, по убыванию
+     */
+    size_t topByMemory(ProcessUsage* oTop, size_t count) const;
+
+    /**
+     * @brief find  Данные процесса по PID
+     */
+    bool find(pid_t pid, ProcessUsage& oUsage) const;
+
+private:
+    struct ProcessTablePrivate;
+    std::shared_ptr<ProcessTablePrivate> d;
+};
+
+} // namespace SystemProcessing
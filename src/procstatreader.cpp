@@ -0,0 +1,241 @@
+#include "procstatreader.hpp"
+#include "probestats.hpp"
+
+#include <charconv>
+#include <cstring>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Enough for ~200 cpu lines per pread, longer files are read in chunks
+constexpr size_t READ_BUFFER_SIZE = 16 * 1024;
+
+bool isCPULine(const char* pos, const char* end) noexcept
+{
+    return (end - pos) > 3 && pos[0] == 'c' && pos[1] == 'p' && pos[2] == 'u';
+}
+
+bool parseCPULine(const char* pos, const char* end, bool& isAggregate, uint32_t& coreId, CPUTimes& oTimes) noexcept
+{
+    pos += 3; // Skip the 'cpu' prefix
+    isAggregate = (*pos == ' ');
+    if (!isAggregate) {
+        auto [ptr, ec] = std::from_chars(pos, end, coreId);
+        if (ec != std::errc()) {
+            return false;
+        }
+        pos = ptr;
+    }
+
+    size_t fieldNo = 0;
+    for (; fieldNo < CPUTimes::FieldsCount; ++fieldNo) {
+        while (pos < end && *pos == ' ') {
+            ++pos;
+        }
+        auto [ptr, ec] = std::from_chars(pos, end, oTimes.fields[fieldNo]);
+        if (ec != std::errc()) {
+            break;
+        }
+        pos = ptr;
+    }
+
+    // Older kernels don't have steal and guest fields
+    for (size_t i = fieldNo; i < CPUTimes::FieldsCount; ++i) {
+        oTimes.fields[i] = 0;
+    }
+    return fieldNo > CPUTimes::Idle;
+}
+
+// Per-CPU iowait may decrease (proc(5)) and idle can step back under NO_HZ: such a mode counts as 0
+uint64_t clampedDelta(uint64_t prev, uint64_t cur) noexcept
+{
+    return cur > prev ? cur - prev : 0;
+}
+
+} // namespace
+
+void CPUTimesTable::clear() noexcept
+{
+    aggregate = {};
+    coreIds.clear();
+    user.clear();
+    system.clear();
+    iowait.clear();
+    steal.clear();
+    idle.clear();
+    total.clear();
+}
+
+void CPUCoresLoad::resize(size_t count)
+{
+    coreIds.resize(count);
+    user.resize(count);
+    system.resize(count);
+    iowait.resize(count);
+    steal.resize(count);
+    idle.resize(count);
+}
+
+double calculateCPULoad(uint64_t prevIdle, uint64_t prevTotal, uint64_t idleTime, uint64_t totalTime) noexcept
+{
+    if (totalTime <= prevTotal) {
+        return 0;
+    }
+    const double idleTimeDelta = idleTime - prevIdle;
+    const double totalTimeDelta = totalTime - prevTotal;
+    return 100.0 * (1.0 - idleTimeDelta / totalTimeDelta);
+}
+
+void calculateCoresDeltas(const CPUTimesTable& prev, const CPUTimesTable& cur, size_t count,
+                          float* user, float* system, float* iowait, float* steal, float* idle) noexcept
+{
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t totalDelta = clampedDelta(prev.total[i], cur.total[i]);
+        const float scale = totalDelta ? 100.0f / static_cast<float>(totalDelta) : 0.0f;
+        user[i]   = static_cast<float>(clampedDelta(prev.user[i], cur.user[i])) * scale;
+        system[i] = static_cast<float>(clampedDelta(prev.system[i], cur.system[i])) * scale;
+        iowait[i] = static_cast<float>(clampedDelta(prev.iowait[i], cur.iowait[i])) * scale;
+        steal[i]  = static_cast<float>(clampedDelta(prev.steal[i], cur.steal[i])) * scale;
+        idle[i]   = static_cast<float>(clampedDelta(prev.idle[i], cur.idle[i])) * scale;
+    }
+}
+
+bool calculateCoresLoad(const CPUTimesTable& prev, const CPUTimesTable& cur, CPUCoresLoad& oLoad)
+{
+    // CPU hotplug between samples
+    if (prev.coreIds != cur.coreIds) {
+        return false;
+    }
+
+    const size_t count = cur.coreCount();
+    oLoad.resize(count);
+    oLoad.coreIds = cur.coreIds;
+    calculateCoresDeltas(prev, cur, count,
+                         oLoad.user.data(), oLoad.system.data(), oLoad.iowait.data(), oLoad.steal.data(), oLoad.idle.data());
+    return true;
+}
+
+ProcStatReader::ProcStatReader(const std::string &statPath) :
+    m_fd {::open(statPath.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+
+}
+
+ProcStatReader::~ProcStatReader()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool ProcStatReader::isOpened() const noexcept
+{
+    return m_fd >= 0;
+}
+
+bool ProcStatReader::readAggregate(CPUTimes &oTimes) const noexcept
+{
+    bool found = false;
+    const bool readOk = forEachCPULine([&](const char* pos, const char* end) {
+        bool isAggregate {};
+        uint32_t coreId {};
+        found = parseCPULine(pos, end, isAggregate, coreId, oTimes) && isAggregate;
+        return false; // Aggregate line is always the first one
+    });
+    return readOk && found;
+}
+
+bool ProcStatReader::read(CPUTimesTable &oTable) const
+{
+    oTable.clear();
+
+    bool aggregateFound = false;
+    bool parseOk = true;
+    const bool readOk = forEachCPULine([&](const char* pos, const char* end) {
+        bool isAggregate {};
+        uint32_t coreId {};
+        CPUTimes times;
+        if (!parseCPULine(pos, end, isAggregate, coreId, times)) {
+            parseOk = false;
+            return false;
+        }
+
+        if (isAggregate) {
+            oTable.aggregate = times;
+            aggregateFound = true;
+            return true;
+        }
+
+        oTable.coreIds.push_back(coreId);
+        oTable.user.push_back(times.fields[CPUTimes::User] + times.fields[CPUTimes::Nice]);
+        oTable.system.push_back(times.fields[CPUTimes::System] + times.fields[CPUTimes::Irq] + times.fields[CPUTimes::Softirq]);
+        oTable.iowait.push_back(times.fields[CPUTimes::Iowait]);
+        oTable.steal.push_back(times.fields[CPUTimes::Steal]);
+        oTable.idle.push_back(times.idle());
+        oTable.total.push_back(times.total());
+        return true;
+    });
+    return readOk && parseOk && aggregateFound;
+}
+
+template<typename LineHandler>
+bool ProcStatReader::forEachCPULine(LineHandler &&handler) const noexcept
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    SYSTEMPROCESSING_PROBE(probe, "procstat.read");
+    char buffer[READ_BUFFER_SIZE];
+    size_t filled = 0;
+    off_t offset = 0;
+
+    while (true)
+    {
+        const auto readBytes = ::pread(m_fd, buffer + filled, sizeof(buffer) - filled, offset);
+        if (readBytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            probe.fail();
+            return false;
+        }
+        probe.addBytes(readBytes);
+        if (readBytes == 0) {
+            return true;
+        }
+        offset += readBytes;
+        filled += readBytes;
+
+        const char* pos = buffer;
+        const char* const end = buffer + filled;
+        while (pos < end)
+        {
+            auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+            if (lineEnd == nullptr) {
+                break;
+            }
+
+            // cpu lines always come first, the rest of the file is not needed
+            if (!isCPULine(pos, lineEnd) || !handler(pos, lineEnd)) {
+                return true;
+            }
+            pos = lineEnd + 1;
+        }
+
+        // Keep the incomplete line for the next chunk
+        filled = end - pos;
+        if (filled == sizeof(buffer)) {
+            return false;
+        }
+        std::memmove(buffer, pos, filled);
+    }
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "fsroot.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <array>
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The CPUTimes struct   Счётчики одной строки cpu из /proc/stat (в USER_HZ)
+ */
+struct CPUTimes
+{
+    enum Field : uint8_t {
+        User,
+        Nice,
+        System,
+        Idle,
+        Iowait,
+        Irq,
+        Softirq,
+        Steal,
+        Guest,
+        GuestNice,
+        FieldsCount
+    };
+
+    std::array<uint64_t, FieldsCount> fields {};
+
+    uint64_t idle() const noexcept { return fields[Idle]; }
+
+    // Guest time is already accounted in user time, so it's not summed
+    uint64_t total() const noexcept
+    {
+        uint64_t result = 0;
+        for (size_t i = User; i <= Steal; ++i) {
+            result += fields[i];
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief The CPUTimesTable struct  Счётчики всех строк cpuN, structure of arrays.
+ *                                  Память выделяется только при росте числа ядер
+ */
+struct CPUTimesTable
+{
+    CPUTimes aggregate;
+
+    std::vector<uint32_t> coreIds;
+    std::vector<uint64_t> user;     // user + nice
+    std::vector<uint64_t> system;   // system + irq + softirq
+    std::vector<uint64_t> iowait;
+    std::vector<uint64_t> steal;
+    std::vector<uint64_t> idle;
+    std::vector<uint64_t> total;
+
+    void clear() noexcept;
+    size_t coreCount() const noexcept { return coreIds.size(); }
+};
+
+/**
+ * @brief The CPUCoresLoad struct   Загруженность по ядрам в процентах, хранится как structure of arrays.
+ *                                  Индекс в массивах соответствует индексу в coreIds
+ */
+struct CPUCoresLoad
+{
+    std::vector<uint32_t> coreIds;  // Номер ядра из строки cpuN
+    std::vector<float> user;        // user + nice
+    std::vector<float> system;      // system + irq + softirq
+    std::vector<float> iowait;
+    std::vector<float> steal;
+    std::vector<float> idle;
+
+    size_t coreCount() const noexcept { return coreIds.size(); }
+    void resize(size_t count);
+};
+
+/**
+ * @brief calculateCPULoad  Загруженность в процентах по двум замерам счётчиков
+ */
+double calculateCPULoad(uint64_t prevIdle, uint64_t prevTotal, uint64_t idleTime, uint64_t totalTime) noexcept;
+
+/**
+ * @brief calculateCoresDeltas  Загруженность ядер по режимам в выходные массивы размера count.
+ *                              Счётчик, уменьшившийся между замерами (iowait, idle при NO_HZ), даёт 0
+ */
+void calculateCoresDeltas(const CPUTimesTable& prev, const CPUTimesTable& cur, size_t count,
+                          float* user, float* system, float* iowait, float* steal, float* idle) noexcept;
+
+/**
+ * @brief calculateCoresLoad    Загруженность ядер по двум таблицам счётчиков
+ * @return  false, если набор ядер изменился между замерами
+ */
+bool calculateCoresLoad(const CPUTimesTable& prev, const CPUTimesTable& cur, CPUCoresLoad& oLoad);
+
+/**
+ * @brief The ProcStatReader class  Читатель /proc/stat без аллокаций: файл открыт всё время жизни объекта,
+ *                                  перечитывается через pread в буфер на стеке
+ */
+class ProcStatReader
+{
+public:
+    explicit ProcStatReader(const std::string& statPath = FsRoot::path("/proc/stat"));
+    ~ProcStatReader();
+
+    ProcStatReader(const ProcStatReader&) = delete;
+    ProcStatReader& operator=(const ProcStatReader&) = delete;
+
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief readAggregate Прочитать только общую строку cpu
+     * @return  false при ошибке чтения или разбора
+     */
+    bool readAggregate(CPUTimes& oTimes) const noexcept;
+
+    /**
+     * @brief read  Прочитать общую строку и строки всех ядер за одно чтение файла
+     * @return  false при ошибке чтения или разбора
+     */
+    bool read(CPUTimesTable& oTable) const;
+
+private:
+    int m_fd {-1};
+
+    template<typename LineHandler>
+    bool forEachCPULine(LineHandler&& handler) const noexcept;
+};
+
+} // namespace SystemProcessing
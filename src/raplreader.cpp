@@ -0,0 +1,155 @@
+#include "raplreader.hpp"
+#include "probestats.hpp"
+#include "sysutil.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Control types that expose RAPL domains; amd-rapl is what some distribution kernels call the AMD driver
+constexpr std::string_view RAPL_ZONE_PREFIXES[] {
+    "intel-rapl:",
+    "amd-rapl:",
+};
+
+constexpr size_t ENERGY_SLOT_CAPACITY = 32;
+
+RaplDomain domainOf(std::string_view name) noexcept
+{
+    if (name.substr(0, 8) == "package-") return RaplDomain::Package;
+    if (name == "core") return RaplDomain::Core;
+    if (name == "uncore") return RaplDomain::Uncore;
+    if (name == "dram") return RaplDomain::Dram;
+    if (name == "psys") return RaplDomain::Platform;
+    return RaplDomain::Unknown;
+}
+
+} // namespace
+
+RaplReader::RaplReader(const std::string &powercapRoot)
+{
+    // "intel-rapl:0" is a package, "intel-rapl:0:1" its subzone. The "intel-rapl" control type directory is skipped
+    std::vector<std::string> zoneNames;
+    if (auto pDir = ::opendir(powercapRoot.c_str()))
+    {
+        while (auto pEntry = ::readdir(pDir))
+        {
+            const std::string_view entryName = pEntry->d_name;
+            for (auto prefix : RAPL_ZONE_PREFIXES) {
+                if (entryName.substr(0, prefix.size()) == prefix) {
+                    zoneNames.emplace_back(entryName);
+                    break;
+                }
+            }
+        }
+        ::closedir(pDir);
+    }
+    std::sort(zoneNames.begin(), zoneNames.end());
+
+    for (auto& zoneName : zoneNames)
+    {
+        RaplZone zone;
+        zone.path = powercapRoot + "/" + zoneName;
+        zone.name = readSmallFile(zone.path + "/name");
+        zone.domain = domainOf(zone.name);
+
+        const auto indexPos = zoneName.find(':') + 1;
+        std::from_chars(zoneName.data() + indexPos, zoneName.data() + zoneName.size(), zone.package);
+        const auto maxRange = readSmallFile(zone.path + "/max_energy_range_uj");
+        std::from_chars(maxRange.data(), maxRange.data() + maxRange.size(), zone.maxEnergyRangeUj);
+
+        if (m_batch.add(zone.path + "/energy_uj", ENERGY_SLOT_CAPACITY) == SysfsBatchReader::INVALID_SLOT) {
+            COMPLOG_WARNING("Error opening RAPL energy counter (root is required since Linux 5.10):", zone.path);
+            continue;
+        }
+        m_zones.push_back(std::move(zone));
+    }
+
+    if (!m_zones.empty()) {
+        sample(m_prevEnergyUj, m_prevTimestampNs);
+    }
+}
+
+bool RaplReader::isOpened() const noexcept
+{
+    return !m_zones.empty();
+}
+
+const std::vector<RaplZone> &RaplReader::zones() const noexcept
+{
+    return m_zones;
+}
+
+bool RaplReader::read(RaplPower &oPower)
+{
+    std::vector<uint64_t> energyUj;
+    uint64_t timestampNs {0};
+    if (m_zones.empty() || !sample(energyUj, timestampNs)) {
+        return false;
+    }
+
+    oPower.timestampNs = timestampNs;
+    oPower.zoneWatts.assign(m_zones.size(), 0);
+    oPower.packageWatts = oPower.coreWatts = oPower.dramWatts = 0;
+
+    const double elapsedSec = (timestampNs - m_prevTimestampNs) / 1e9;
+    if (elapsedSec > 0) {
+        for (size_t i = 0; i < m_zones.size(); ++i)
+        {
+            const double watts = energyDelta(m_prevEnergyUj[i], energyUj[i], m_zones[i].maxEnergyRangeUj) / 1e6 / elapsedSec;
+            oPower.zoneWatts[i] = watts;
+            switch (m_zones[i].domain)
+            {
+            case RaplDomain::Package:   oPower.packageWatts += watts; break;
+            case RaplDomain::Core:      oPower.coreWatts += watts; break;
+            case RaplDomain::Dram:      oPower.dramWatts += watts; break;
+            default: break;
+            }
+        }
+    }
+
+    std::swap(m_prevEnergyUj, energyUj);
+    m_prevTimestampNs = timestampNs;
+    return true;
+}
+
+uint64_t RaplReader::energyDelta(uint64_t prevUj, uint64_t curUj, uint64_t maxEnergyRangeUj) noexcept
+{
+    if (curUj >= prevUj) {
+        return curUj - prevUj;
+    }
+    // The counter wrapped at max_energy_range_uj; without the range the sample is dropped
+    return maxEnergyRangeUj > prevUj ? maxEnergyRangeUj - prevUj + curUj : 0;
+}
+
+bool RaplReader::sample(std::vector<uint64_t> &oEnergyUj, uint64_t &oTimestampNs)
+{
+    SYSTEMPROCESSING_PROBE(probe, "rapl.read");
+    m_batch.readAll();
+    oTimestampNs = monotonicNs();
+
+    oEnergyUj.resize(m_zones.size());
+    for (size_t i = 0; i < m_zones.size(); ++i) {
+        int64_t energyUj {0};
+        if (!m_batch.value(i, energyUj)) {
+            probe.fail();
+            return false;
+        }
+        oEnergyUj[i] = static_cast<uint64_t>(energyUj);
+    }
+    return true;
+}
+
+} // namespace SystemProcessing
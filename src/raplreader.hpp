@@ -0,0 +1,87 @@
+#pragma once
+
+#include "fsroot.hpp"
+#include "sysfsbatchreader.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <vector>
+
+namespace SystemProcessing {
+
+enum class RaplDomain : uint8_t {
+    Package,
+    Core,
+    Uncore,
+    Dram,
+    Platform,   // psys
+    Unknown
+};
+
+/**
+ * @brief The RaplZone struct  Зона powercap: корпус процессора или его подзона (ядра, uncore, память)
+ */
+struct RaplZone
+{
+    std::string path;           // Каталог зоны в /sys/class/powercap
+    std::string name;           // Содержимое файла name ("package-0", "core", "dram"...)
+    RaplDomain domain {RaplDomain::Unknown};
+    int package {0};            // Номер корпуса, к которому относится зона
+    uint64_t maxEnergyRangeUj {0};
+};
+
+/**
+ * @brief The RaplPower struct Мощность в ваттах за интервал между двумя чтениями
+ */
+struct RaplPower
+{
+    uint64_t timestampNs {0};   // CLOCK_MONOTONIC
+    std::vector<double> zoneWatts;  // По индексам RaplReader::zones()
+
+    // Суммы по всем корпусам, 0 — домен не поддерживается
+    double packageWatts {0};
+    double coreWatts {0};
+    double dramWatts {0};
+};
+
+/**
+ * @brief The RaplReader class Мощность процессора по счётчикам энергии RAPL (intel-rapl powercap,
+ *                             его же использует amd_energy/rapl на AMD Zen). Файлы energy_uj открыты всё время жизни
+ *                             объекта и читаются одним пакетом; мощность — разность с предыдущим чтением,
+ *                             с учётом переполнения по max_energy_range_uj.
+ *                             С ядра 5.10 energy_uj доступен только root
+ */
+class RaplReader
+{
+public:
+    explicit RaplReader(const std::string& powercapRoot = FsRoot::path("/sys/class/powercap"));
+
+    RaplReader(const RaplReader&) = delete;
+    RaplReader& operator=(const RaplReader&) = delete;
+
+    bool isOpened() const noexcept;
+    const std::vector<RaplZone>& zones() const noexcept;
+
+    /**
+     * @brief read  Мощность с предыдущего вызова (первый раз — с создания объекта)
+     * @return  false, если счётчики не прочитаны
+     */
+    bool read(RaplPower& oPower);
+
+    /**
+     * @brief energyDelta   Приращение счётчика с учётом одного переполнения
+     */
+    static uint64_t energyDelta(uint64_t prevUj, uint64_t curUj, uint64_t maxEnergyRangeUj) noexcept;
+
+private:
+    std::vector<RaplZone> m_zones;
+    SysfsBatchReader m_batch;   // Слот i — energy_uj зоны i
+
+    std::vector<uint64_t> m_prevEnergyUj;
+    uint64_t m_prevTimestampNs {0};
+
+    bool sample(std::vector<uint64_t>& oEnergyUj, uint64_t& oTimestampNs);
+};
+
+} // namespace SystemProcessing
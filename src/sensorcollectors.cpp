@@ -0,0 +1,301 @@
+#include "sensorcollectors.hpp"
+
+#include <Components/Logger/Logger.h>
+#include <Components/Filework/Common.h>
+
+#include <algorithm>
+#include <string_view>
+
+#include <dirent.h>
+
+#if SYSTEMPROCESSING_WITH_NVIDIA
+#include <NVML/nvml.h>
+#endif // SYSTEMPROCESSING_WITH_NVIDIA
+
+namespace SystemProcessing {
+
+bool CPUCollector::init()
+{
+    m_hasPrevious = m_reader.isOpened() && m_reader.read(m_prevTimes);
+    return m_hasPrevious;
+}
+
+void CPUCollector::collect(Sample &oSample)
+{
+    if (!m_reader.read(m_times)) {
+        return;
+    }
+
+    if (m_hasPrevious) {
+        oSample.load = calculateCPULoad(m_prevTimes.aggregate.idle(), m_prevTimes.aggregate.total(),
+                                        m_times.aggregate.idle(), m_times.aggregate.total());
+        calculateCoresLoad(m_prevTimes, m_times, oSample.cores);
+    }
+    std::swap(m_prevTimes, m_times);
+    m_hasPrevious = true;
+}
+
+bool MemoryCollector::init()
+{
+    return m_reader.isOpened();
+}
+
+void MemoryCollector::collect(Sample &oSample)
+{
+    m_reader.read(oSample);
+}
+
+#if SYSTEMPROCESSING_WITH_HWMON
+bool HwmonCollector::init()
+{
+    m_registry = std::make_unique<HwmonRegistry>();
+    m_cpuSensor = m_registry->findCPUTemperature();
+
+    m_temperatureSensors.clear();
+    for (auto& sensor : m_registry->sensors()) {
+        if (sensor.type == SensorType::Temperature && m_temperatureSensors.size() < MAX_TEMPERATURES) {
+            m_temperatureSensors.push_back(&sensor);
+        }
+    }
+    return !m_temperatureSensors.empty();
+}
+
+void HwmonCollector::collect(Sample &oSample)
+{
+    if (m_cpuSensor != nullptr) {
+        m_registry->read(*m_cpuSensor, oSample.cpuTemperature);
+    }
+
+    oSample.temperatureCount = static_cast<uint32_t>(m_temperatureSensors.size());
+    for (size_t i = 0; i < m_temperatureSensors.size(); ++i) {
+        double celsius {0};
+        m_registry->read(*m_temperatureSensors[i], celsius);
+        oSample.temperatures[i] = static_cast<float>(celsius);
+    }
+}
+
+const std::vector<const HwmonSensor *> &HwmonCollector::sensors() const noexcept
+{
+    return m_temperatureSensors;
+}
+#endif // SYSTEMPROCESSING_WITH_HWMON
+
+#if SYSTEMPROCESSING_WITH_PSI
+bool PressureCollector::init()
+{
+    m_reader = std::make_unique<PressureReader>();
+    return m_reader->isAvailable(PressureResource::CPU) ||
+           m_reader->isAvailable(PressureResource::Memory) ||
+           m_reader->isAvailable(PressureResource::IO);
+}
+
+void PressureCollector::collect(Sample &oSample)
+{
+    for (auto resource : {PressureResource::CPU, PressureResource::Memory, PressureResource::IO}) {
+        m_reader->read(resource, oSample.resources[static_cast<size_t>(resource)]);
+    }
+}
+#endif // SYSTEMPROCESSING_WITH_PSI
+
+#if SYSTEMPROCESSING_WITH_AMDGPU
+AMDGPUCollector::AMDGPUCollector(const std::string &drmRoot) :
+    m_drmRoot {drmRoot}
+{
+
+}
+
+bool AMDGPUCollector::init()
+{
+    m_batch.clear();
+    m_cards.clear();
+
+    auto drmDir = opendir(m_drmRoot.c_str());
+    if (drmDir == nullptr) {
+        return false;
+    }
+
+    std::vector<uint32_t> cardIndexes;
+    while (auto entry = readdir(drmDir)) {
+        // Connectors look like card0-DP-1 and are skipped by the check of the whole tail
+        const std::string_view name = entry->d_name;
+        if (name.substr(0, 4) != "card" || name.size() == 4 ||
+            name.find_first_not_of("0123456789", 4) != std::string_view::npos) {
+            continue;
+        }
+        cardIndexes.push_back(std::stoul(std::string(name.substr(4))));
+    }
+    closedir(drmDir);
+    std::sort(cardIndexes.begin(), cardIndexes.end());
+
+    for (auto cardIndex : cardIndexes)
+    {
+        const auto deviceDir = m_drmRoot + "/card" + std::to_string(cardIndex) + "/device";
+        std::string vendor;
+        if (!Filework::Common::readFileData(deviceDir + "/vendor", vendor) || vendor.find("0x1002") != 0) {
+            continue;
+        }
+        if (m_cards.size() == MAX_GPUS) {
+            COMPLOG_WARNING("Too many AMD GPUs, the rest are not collected");
+            break;
+        }
+
+        CardSlots slots;
+        slots.cardIndex = cardIndex;
+        slots.busy     = m_batch.add(deviceDir + "/gpu_busy_percent", 16);
+        slots.vramUsed = m_batch.add(deviceDir + "/mem_info_vram_used", 32);
+
+        const auto hwmonRoot = deviceDir + "/hwmon";
+        if (auto hwmonDir = opendir(hwmonRoot.c_str())) {
+            while (auto entry = readdir(hwmonDir)) {
+                if (std::string_view(entry->d_name).substr(0, 5) != "hwmon") {
+                    continue;
+                }
+                const auto hwmonPath = hwmonRoot + "/" + entry->d_name;
+                slots.temperature = m_batch.add(hwmonPath + "/temp1_input", 32);
+                slots.power = m_batch.add(hwmonPath + "/power1_average", 32);
+                if (slots.power == SysfsBatchReader::INVALID_SLOT) {
+                    slots.power = m_batch.add(hwmonPath + "/power1_input", 32);
+                }
+                break;
+            }
+            closedir(hwmonDir);
+        }
+        m_cards.push_back(slots);
+    }
+    return !m_cards.empty();
+}
+
+void AMDGPUCollector::collect(Sample &oSample)
+{
+    m_batch.readAll();
+
+    oSample.gpuCount = static_cast<uint32_t>(m_cards.size());
+    for (size_t i = 0; i < m_cards.size(); ++i)
+    {
+        const auto& slots = m_cards[i];
+        auto& rGpu = oSample.gpus[i];
+        rGpu.cardIndex = slots.cardIndex;
+
+        int64_t value {0};
+        rGpu.busyPercent = m_batch.value(slots.busy, value) ? static_cast<int32_t>(value) : -1;
+        rGpu.vramUsed    = m_batch.value(slots.vramUsed, value) ? static_cast<uint64_t>(value) : 0;
+        // hwmon ABI units: millidegree Celsius and microwatt
+        rGpu.temperature = m_batch.value(slots.temperature, value) ? value * 1e-3 : 0;
+        rGpu.powerWatts  = m_batch.value(slots.power, value) ? value * 1e-6 : 0;
+    }
+}
+#endif // SYSTEMPROCESSING_WITH_AMDGPU
+
+#if SYSTEMPROCESSING_WITH_NVIDIA
+NvidiaGPUCollector::~NvidiaGPUCollector()
+{
+    if (m_isInited) {
+        nvmlShutdown();
+    }
+}
+
+bool NvidiaGPUCollector::init()
+{
+    const auto result = nvmlInit();
+    if (result != NVML_SUCCESS) {
+        COMPLOG_WARNING("NVML init error:", nvmlErrorString(result));
+        return false;
+    }
+    m_isInited = true;
+
+    unsigned int deviceCount {0};
+    if (nvmlDeviceGetCount(&deviceCount) != NVML_SUCCESS) {
+        return false;
+    }
+
+    m_devices.clear();
+    for (unsigned int i = 0; i < deviceCount && m_devices.size() < MAX_GPUS; ++i) {
+        nvmlDevice_t device {};
+        if (nvmlDeviceGetHandleByIndex(i, &device) == NVML_SUCCESS) {
+            m_devices.push_back(device);
+        }
+    }
+    return !m_devices.empty();
+}
+
+void NvidiaGPUCollector::collect(Sample &oSample)
+{
+    oSample.gpuCount = static_cast<uint32_t>(m_devices.size());
+    for (size_t i = 0; i < m_devices.size(); ++i)
+    {
+        auto device = static_cast<nvmlDevice_t>(m_devices[i]);
+        auto& rGpu = oSample.gpus[i];
+        rGpu.index = static_cast<uint32_t>(i);
+
+        nvmlUtilization_t utilization {};
+        rGpu.busyPercent = nvmlDeviceGetUtilizationRates(device, &utilization) == NVML_SUCCESS
+                           ? static_cast<int32_t>(utilization.gpu) : -1;
+
+        unsigned int temperature {0};
+        nvmlDeviceGetTemperature(device, NVML_TEMPERATURE_GPU, &temperature);
+        rGpu.temperature = temperature;
+
+        unsigned int powerMilliwatts {0};
+        nvmlDeviceGetPowerUsage(device, &powerMilliwatts);
+        rGpu.powerWatts = powerMilliwatts * 1e-3;
+
+        nvmlMemory_t memory {};
+        rGpu.vramUsed = nvmlDeviceGetMemoryInfo(device, &memory) == NVML_SUCCESS ? memory.used : 0;
+    }
+}
+#endif // SYSTEMPROCESSING_WITH_NVIDIA
+
+#if SYSTEMPROCESSING_WITH_NETWORK
+bool NetworkCollector::init()
+{
+    return m_reader.isOpened();
+}
+
+void NetworkCollector::collect(Sample &oSample)
+{
+    m_reader.read(oSample.interfaces);
+}
+#endif // SYSTEMPROCESSING_WITH_NETWORK
+
+#if SYSTEMPROCESSING_WITH_DISKS
+bool DiskCollector::init()
+{
+    return m_reader.isOpened();
+}
+
+void DiskCollector::collect(Sample &oSample)
+{
+    m_reader.read(oSample.disks);
+}
+#endif // SYSTEMPROCESSING_WITH_DISKS
+
+#if SYSTEMPROCESSING_WITH_PERF
+bool PerfCollector::init()
+{
+    return m_counters.open();
+}
+
+void PerfCollector::collect(Sample &oSample)
+{
+    if (!m_counters.read(oSample.counters)) {
+        return;
+    }
+    oSample.rates = m_prevCounters.timestampNs != 0 ? PerfCounters::rates(m_prevCounters, oSample.counters) : PerfRates {};
+    m_prevCounters = oSample.counters;
+}
+#endif // SYSTEMPROCESSING_WITH_PERF
+
+#if SYSTEMPROCESSING_WITH_RAPL
+bool PowerCollector::init()
+{
+    m_reader = std::make_unique<RaplReader>();
+    return m_reader->isOpened();
+}
+
+void PowerCollector::collect(Sample &oSample)
+{
+    m_reader->read(oSample);
+}
+#endif // SYSTEMPROCESSING_WITH_RAPL
+
+} // namespace SystemProcessing
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "collectoroptions.hpp"
+#include "diskstatsreader.hpp"
+#include "fsroot.hpp"
+#include "hwmonregistry.hpp"
+#include "meminforeader.hpp"
+#include "netdevreader.hpp"
+#include "perfcounters.hpp"
+#include "pressuremonitor.hpp"
+#include "procstatreader.hpp"
+#include "raplreader.hpp"
+#include "sysfsbatchreader.hpp"
+
+#include <stdint.h>
+#include <string>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace SystemProcessing {
+
+/*
+ * Коллекторы для SensorRegistry. Каждый коллектор — обычный класс без виртуальных функций:
+ *   struct Sample;                 Результат одного прохода
+ *   bool init();                   false — источник недоступен на этой машине, коллектор пропускается
+ *   void collect(Sample& oSample); Заполнить Sample без лишних аллокаций
+ */
+
+/**
+ * @brief The CPUCollector class   Общая и поядерная загрузка из /proc/stat с момента предыдущего прохода
+ */
+class CPUCollector
+{
+public:
+    struct Sample {
+        double load {0};
+        CPUCoresLoad cores;
+    };
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    ProcStatReader m_reader;
+    CPUTimesTable m_prevTimes;
+    CPUTimesTable m_times;
+    bool m_hasPrevious {false};
+};
+
+/**
+ * @brief The MemoryCollector class    /proc/meminfo
+ */
+class MemoryCollector
+{
+public:
+    using Sample = MemoryStats;
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    MeminfoReader m_reader;
+};
+
+#if SYSTEMPROCESSING_WITH_HWMON
+/**
+ * @brief The HwmonCollector class Температура процессора и все температурные датчики hwmon
+ */
+class HwmonCollector
+{
+public:
+    static constexpr size_t MAX_TEMPERATURES = 32;
+
+    struct Sample {
+        double cpuTemperature {0};
+        uint32_t temperatureCount {0};
+        std::array<float, MAX_TEMPERATURES> temperatures {};   // Индекс — в sensors()
+    };
+
+    bool init();
+    void collect(Sample& oSample);
+
+    const std::vector<const HwmonSensor*>& sensors() const noexcept;
+
+private:
+    std::unique_ptr<HwmonRegistry> m_registry;
+    const HwmonSensor* m_cpuSensor {nullptr};
+    std::vector<const HwmonSensor*> m_temperatureSensors;
+};
+#endif // SYSTEMPROCESSING_WITH_HWMON
+
+#if SYSTEMPROCESSING_WITH_PSI
+/**
+ * @brief The PressureCollector class  Системный PSI по всем ресурсам
+ */
+class PressureCollector
+{
+public:
+    struct Sample {
+        std::array<PressureReading, 3> resources {};    // Индекс — PressureResource
+    };
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    std::unique_ptr<PressureReader> m_reader;
+};
+#endif // SYSTEMPROCESSING_WITH_PSI
+
+#if SYSTEMPROCESSING_WITH_AMDGPU
+/**
+ * @brief The AMDGPUCollector class    Карты amdgpu из /sys/class/drm: загрузка, температура, мощность, VRAM.
+ *                                     Все файлы всех карт читаются одним пакетом SysfsBatchReader
+ */
+class AMDGPUCollector
+{
+public:
+    static constexpr size_t MAX_GPUS = 16;
+
+    struct GPUReading {
+        uint32_t cardIndex {0};     // N из /sys/class/drm/cardN
+        int32_t busyPercent {-1};   // -1 — значение недоступно
+        double temperature {0};     // Цельсии
+        double powerWatts {0};
+        uint64_t vramUsed {0};      // Байты
+    };
+
+    struct Sample {
+        uint32_t gpuCount {0};
+        std::array<GPUReading, MAX_GPUS> gpus {};
+    };
+
+    explicit AMDGPUCollector(const std::string& drmRoot = FsRoot::path("/sys/class/drm"));
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    struct CardSlots {
+        uint32_t cardIndex {0};
+        size_t busy {SysfsBatchReader::INVALID_SLOT};
+        size_t temperature {SysfsBatchReader::INVALID_SLOT};
+        size_t power {SysfsBatchReader::INVALID_SLOT};
+        size_t vramUsed {SysfsBatchReader::INVALID_SLOT};
+    };
+
+    std::string m_drmRoot;
+    SysfsBatchReader m_batch;
+    std::vector<CardSlots> m_cards;
+};
+#endif // SYSTEMPROCESSING_WITH_AMDGPU
+
+#if SYSTEMPROCESSING_WITH_NVIDIA
+/**
+ * @brief The NvidiaGPUCollector class Карты NVIDIA через NVML. Собирается только с SYSTEMPROCESSING_WITH_NVIDIA
+ */
+class NvidiaGPUCollector
+{
+public:
+    static constexpr size_t MAX_GPUS = 16;
+
+    struct GPUReading {
+        uint32_t index {0};
+        int32_t busyPercent {-1};
+        double temperature {0};
+        double powerWatts {0};
+        uint64_t vramUsed {0};
+    };
+
+    struct Sample {
+        uint32_t gpuCount {0};
+        std::array<GPUReading, MAX_GPUS> gpus {};
+    };
+
+    ~NvidiaGPUCollector();
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    std::vector<void*> m_devices;   // nvmlDevice_t
+    bool m_isInited {false};
+};
+#endif // SYSTEMPROCESSING_WITH_NVIDIA
+
+#if SYSTEMPROCESSING_WITH_NETWORK
+/**
+ * @brief The NetworkCollector class   Счётчики сетевых интерфейсов кроме lo
+ */
+class NetworkCollector
+{
+public:
+    struct Sample {
+        std::vector<NetworkInterfaceStats> interfaces;
+    };
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    NetDevReader m_reader;
+};
+#endif // SYSTEMPROCESSING_WITH_NETWORK
+
+#if SYSTEMPROCESSING_WITH_DISKS
+/**
+ * @brief The DiskCollector class  Счётчики блочных устройств кроме loop, ram и zram
+ */
+class DiskCollector
+{
+public:
+    struct Sample {
+        std::vector<DiskStats> disks;
+    };
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    DiskStatsReader m_reader;
+};
+#endif // SYSTEMPROCESSING_WITH_DISKS
+
+#if SYSTEMPROCESSING_WITH_PERF
+/**
+ * @brief The PerfCollector class  Системные счётчики perf_event_open и скорости с предыдущего прохода.
+ *                                 Недоступен без прав на perf; без PMU собирает только программные счётчики
+ */
+class PerfCollector
+{
+public:
+    struct Sample {
+        PerfCountersSample counters;
+        PerfRates rates;
+    };
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    PerfCounters m_counters;
+    PerfCountersSample m_prevCounters;
+};
+#endif // SYSTEMPROCESSING_WITH_PERF
+
+#if SYSTEMPROCESSING_WITH_RAPL
+/**
+ * @brief The PowerCollector class Мощность корпусов, ядер и памяти по RAPL с предыдущего прохода
+ */
+class PowerCollector
+{
+public:
+    using Sample = RaplPower;
+
+    bool init();
+    void collect(Sample& oSample);
+
+private:
+    std::unique_ptr<RaplReader> m_reader;
+};
+#endif // SYSTEMPROCESSING_WITH_RAPL
+
+} // namespace SystemProcessing
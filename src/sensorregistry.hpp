@@ -0,0 +1,188 @@
+#pragma once
+
+#include "sensorcollectors.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The SensorRegistry class Набор коллекторов, выбранный на этапе компиляции.
+ *                                  Снимок — кортеж Sample выбранных коллекторов, проход по ним
+ *                                  разворачивается компилятором без виртуальных вызовов
+ */
+template<typename... Collectors>
+class SensorRegistry
+{
+    static_assert(sizeof...(Collectors) > 0, "SensorRegistry needs at least one collector");
+
+public:
+    using Snapshot = std::tuple<typename Collectors::Sample...>;
+
+    static constexpr size_t COLLECTORS_COUNT = sizeof...(Collectors);
+
+    template<typename Collector>
+    static constexpr bool contains() noexcept
+    {
+        return (std::is_same_v<Collector, Collectors> || ...);
+    }
+
+    /**
+     * @brief init  Открыть источники всех коллекторов
+     * @return  Число доступных коллекторов. Недоступные пропускаются при collect
+     */
+    size_t init()
+    {
+        size_t availableCount = 0;
+        initImpl(availableCount, std::index_sequence_for<Collectors...>{});
+        return availableCount;
+    }
+
+    template<typename Collector>
+    bool isAvailable() const noexcept
+    {
+        return m_isAvailable[indexOf<Collector>()];
+    }
+
+    /**
+     * @brief collect   Один проход по всем доступным коллекторам
+     */
+    void collect(Snapshot& oSnapshot)
+    {
+        collectImpl(oSnapshot, std::index_sequence_for<Collectors...>{});
+    }
+
+    template<typename Collector>
+    Collector& collector() noexcept
+    {
+        return std::get<indexOf<Collector>()>(m_collectors);
+    }
+
+    template<typename Collector>
+    static const typename Collector::Sample& sample(const Snapshot& snapshot) noexcept
+    {
+        return std::get<indexOf<Collector>()>(snapshot);
+    }
+
+    /**
+     * @brief sampleLoop    Цикл сэмплирования в текущем потоке до stopRequested.
+     *                      handler(const Snapshot&) вызывается после каждого прохода
+     */
+    template<typename Handler>
+    void sampleLoop(std::chrono::nanoseconds interval, const std::atomic<bool>& stopRequested, Handler&& handler)
+    {
+        Snapshot snapshot {};
+        auto nextWakeup = std::chrono::steady_clock::now();
+        while (!stopRequested.load(std::memory_order_relaxed)) {
+            collect(snapshot);
+            handler(static_cast<const Snapshot&>(snapshot));
+
+            // Fixed rate: a slow pass shortens the next sleep instead of shifting the schedule
+            nextWakeup += interval;
+            const auto now = std::chrono::steady_clock::now();
+            if (nextWakeup < now) {
+                nextWakeup = now;
+            }
+            std::this_thread::sleep_until(nextWakeup);
+        }
+    }
+
+private:
+    std::tuple<Collectors...> m_collectors;
+    std::array<bool, COLLECTORS_COUNT> m_isAvailable {};
+
+    template<typename Collector>
+    static constexpr size_t indexOf() noexcept
+    {
+        static_assert(contains<Collector>(), "Collector is not in the registry");
+
+        constexpr bool matches[] {std::is_same_v<Collector, Collectors>...};
+        size_t index = 0;
+        while (!matches[index]) {
+            ++index;
+        }
+        return index;
+    }
+
+    template<size_t... Indexes>
+    void initImpl(size_t& oAvailableCount, std::index_sequence<Indexes...>)
+    {
+        ((m_isAvailable[Indexes] = std::get<Indexes>(m_collectors).init(),
+          oAvailableCount += m_isAvailable[Indexes]), ...);
+    }
+
+    template<size_t... Indexes>
+    void collectImpl(Snapshot& oSnapshot, std::index_sequence<Indexes...>)
+    {
+        ((m_isAvailable[Indexes] ? std::get<Indexes>(m_collectors).collect(std::get<Indexes>(oSnapshot)) : void()), ...);
+    }
+};
+
+namespace Detail
+{
+
+template<typename... Types>
+struct TypeList {};
+
+template<typename... Lists>
+struct Concat;
+
+template<typename... Types>
+struct Concat<TypeList<Types...>> {
+    using type = TypeList<Types...>;
+};
+
+template<typename... First, typename... Second, typename... Rest>
+struct Concat<TypeList<First...>, TypeList<Second...>, Rest...> {
+    using type = typename Concat<TypeList<First..., Second...>, Rest...>::type;
+};
+
+template<typename List>
+struct RegistryOf;
+
+template<typename... Types>
+struct RegistryOf<TypeList<Types...>> {
+    using type = SensorRegistry<Types...>;
+};
+
+} // namespace Detail
+
+/**
+ * @brief DefaultSensorRegistry    Коллекторы, включённые опциями SYSTEMPROCESSING_WITH_* при сборке
+ */
+using DefaultSensorRegistry = typename Detail::RegistryOf<typename Detail::Concat<
+    Detail::TypeList<CPUCollector, MemoryCollector>,
+#if SYSTEMPROCESSING_WITH_HWMON
+    Detail::TypeList<HwmonCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_PSI
+    Detail::TypeList<PressureCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_AMDGPU
+    Detail::TypeList<AMDGPUCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_NVIDIA
+    Detail::TypeList<NvidiaGPUCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_NETWORK
+    Detail::TypeList<NetworkCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_DISKS
+    Detail::TypeList<DiskCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_PERF
+    Detail::TypeList<PerfCollector>,
+#endif
+#if SYSTEMPROCESSING_WITH_RAPL
+    Detail::TypeList<PowerCollector>,
+#endif
+    Detail::TypeList<>
+>::type>::type;
+
+} // namespace SystemProcessing
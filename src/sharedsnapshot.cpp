@@ -0,0 +1,237 @@
+#include "sharedsnapshot.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+struct SharedSnapshotSegment
+{
+    static constexpr uint32_t MAGIC = 0x53505353; // "SPSS"
+    static constexpr uint32_t VERSION = 7;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t snapshotSize;
+
+    // Process of the current publisher, 0 after it stopped. Each publisher takes a new generation
+    std::atomic<int32_t> publisherPid;
+    std::atomic<uint64_t> generation;
+
+    // Odd while the publisher writes, number of publications is sequence / 2
+    alignas(64) std::atomic<uint64_t> sequence;
+    alignas(64) StatusSnapshot snapshot;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Seqlock counter must be lock-free to be shared between processes");
+static_assert(std::atomic<int32_t>::is_always_lock_free, "Publisher pid must be lock-free to be shared between processes");
+
+// A write takes a few microseconds; a sequence that stays odd longer means a publisher killed mid-write
+constexpr int READ_ATTEMPTS = 4096;
+
+SharedSnapshotPublisher::SharedSnapshotPublisher(const std::string &segmentName) :
+    m_segmentName {segmentName}
+{
+    m_fd = shm_open(m_segmentName.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        COMPLOG_ERROR("Error creating shared memory segment:", m_segmentName, strerror(errno));
+        return;
+    }
+
+    // The lock is released with the process, so a crashed publisher doesn't block its restart
+    if (flock(m_fd, LOCK_EX | LOCK_NB) != 0) {
+        COMPLOG_ERROR("Shared memory segment is already published:", m_segmentName, strerror(errno));
+        ::close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    struct stat segmentStat;
+    if (fstat(m_fd, &segmentStat) != 0 || ftruncate(m_fd, sizeof(SharedSnapshotSegment)) != 0) {
+        COMPLOG_ERROR("Error resizing shared memory segment:", m_segmentName, strerror(errno));
+        ::close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    auto pMemory = mmap(nullptr, sizeof(SharedSnapshotSegment), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (pMemory == MAP_FAILED) {
+        COMPLOG_ERROR("Error mapping shared memory segment:", m_segmentName, strerror(errno));
+        ::close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_pSegment = static_cast<SharedSnapshotSegment*>(pMemory);
+
+    // A segment left by a crashed publisher may have readers: its sequence continues,
+    // an unfinished write is closed, and the new generation tells them about the restart
+    const bool isCompatible = static_cast<size_t>(segmentStat.st_size) == sizeof(SharedSnapshotSegment)
+            && m_pSegment->magic == SharedSnapshotSegment::MAGIC
+            && m_pSegment->version == SharedSnapshotSegment::VERSION
+            && m_pSegment->snapshotSize == sizeof(StatusSnapshot);
+    if (isCompatible) {
+        const auto seq = m_pSegment->sequence.load(std::memory_order_relaxed);
+        m_pSegment->sequence.store(seq + (seq & 1), std::memory_order_release);
+    } else {
+        m_pSegment->sequence.store(0, std::memory_order_relaxed);
+        m_pSegment->generation.store(0, std::memory_order_relaxed);
+        m_pSegment->magic = SharedSnapshotSegment::MAGIC;
+        m_pSegment->version = SharedSnapshotSegment::VERSION;
+        m_pSegment->snapshotSize = sizeof(StatusSnapshot);
+    }
+    m_pSegment->generation.fetch_add(1, std::memory_order_relaxed);
+    m_pSegment->publisherPid.store(static_cast<int32_t>(getpid()), std::memory_order_release);
+}
+
+SharedSnapshotPublisher::~SharedSnapshotPublisher()
+{
+    if (m_pSegment != nullptr) {
+        // Readers still mapping the unlinked segment see that it's abandoned
+        m_pSegment->publisherPid.store(0, std::memory_order_release);
+        munmap(m_pSegment, sizeof(SharedSnapshotSegment));
+        shm_unlink(m_segmentName.c_str());
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool SharedSnapshotPublisher::isOpened() const noexcept
+{
+    return m_pSegment != nullptr;
+}
+
+void SharedSnapshotPublisher::publish(const StatusSnapshot &snapshot) noexcept
+{
+    if (m_pSegment == nullptr) {
+        return;
+    }
+
+    const auto seq = m_pSegment->sequence.load(std::memory_order_relaxed);
+    m_pSegment->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&m_pSegment->snapshot, &snapshot, sizeof(StatusSnapshot));
+
+    m_pSegment->sequence.store(seq + 2, std::memory_order_release);
+}
+
+SharedSnapshotReader::SharedSnapshotReader(const std::string &segmentName) :
+    m_segmentName {segmentName}
+{
+    open();
+}
+
+SharedSnapshotReader::~SharedSnapshotReader()
+{
+    close();
+}
+
+bool SharedSnapshotReader::open()
+{
+    close();
+
+    const int fd = shm_open(m_segmentName.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat segmentStat;
+    if (fstat(fd, &segmentStat) != 0 || static_cast<size_t>(segmentStat.st_size) < sizeof(SharedSnapshotSegment)) {
+        ::close(fd);
+        return false;
+    }
+
+    auto pMemory = mmap(nullptr, sizeof(SharedSnapshotSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (pMemory == MAP_FAILED) {
+        return false;
+    }
+
+    auto pSegment = static_cast<const SharedSnapshotSegment*>(pMemory);
+    if (pSegment->magic != SharedSnapshotSegment::MAGIC ||
+        pSegment->version != SharedSnapshotSegment::VERSION ||
+        pSegment->snapshotSize != sizeof(StatusSnapshot)) {
+        COMPLOG_WARNING("Incompatible shared memory segment:", m_segmentName);
+        munmap(pMemory, sizeof(SharedSnapshotSegment));
+        return false;
+    }
+
+    m_pSegment = pSegment;
+    m_generation = pSegment->generation.load(std::memory_order_acquire);
+    return true;
+}
+
+bool SharedSnapshotReader::isOpened() const noexcept
+{
+    return m_pSegment != nullptr;
+}
+
+uint64_t SharedSnapshotReader::sequence() const noexcept
+{
+    if (m_pSegment == nullptr) {
+        return 0;
+    }
+    return m_pSegment->sequence.load(std::memory_order_acquire) / 2;
+}
+
+bool SharedSnapshotReader::read(StatusSnapshot &oSnapshot) const noexcept
+{
+    if (m_pSegment == nullptr || m_pSegment->publisherPid.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // A live publisher gets a second round, e.g. when it was preempted in the middle of a write
+    for (int round = 0; round < 2; ++round)
+    {
+        for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+        {
+            const auto seq = m_pSegment->sequence.load(std::memory_order_acquire);
+            if ((seq & 1) == 0) {
+                std::memcpy(&oSnapshot, &m_pSegment->snapshot, sizeof(StatusSnapshot));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq == m_pSegment->sequence.load(std::memory_order_relaxed)) {
+                    return seq != 0;
+                }
+            }
+            ::sched_yield();
+        }
+        if (isStale()) {
+            break;
+        }
+    }
+    return false;
+}
+
+bool SharedSnapshotReader::isStale() const noexcept
+{
+    if (m_pSegment == nullptr) {
+        return true;
+    }
+    if (m_pSegment->generation.load(std::memory_order_acquire) != m_generation) {
+        return true;
+    }
+    // EPERM means the process exists under another user
+    const auto publisherPid = m_pSegment->publisherPid.load(std::memory_order_acquire);
+    return publisherPid == 0 || (::kill(publisherPid, 0) != 0 && errno == ESRCH);
+}
+
+void SharedSnapshotReader::close() noexcept
+{
+    if (m_pSegment != nullptr) {
+        munmap(const_cast<SharedSnapshotSegment*>(m_pSegment), sizeof(SharedSnapshotSegment));
+        m_pSegment = nullptr;
+    }
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "statussnapshot.hpp"
+
+#include <string>
+
+namespace SystemProcessing {
+
+struct SharedSnapshotSegment;
+
+/**
+ * @brief The SharedSnapshotPublisher class    Публикация StatusSnapshot в разделяемую память POSIX (shm_open).
+ *                                              Читатели в других процессах получают данные без системных вызовов.
+ *                                              Издатель у сегмента один (flock): второй не откроется, пока жив первый
+ */
+class SharedSnapshotPublisher
+{
+public:
+    static constexpr const char* DEFAULT_SEGMENT_NAME = "/SystemProcessing.status";
+
+    explicit SharedSnapshotPublisher(const std::string& segmentName = DEFAULT_SEGMENT_NAME);
+    ~SharedSnapshotPublisher();
+
+    SharedSnapshotPublisher(const SharedSnapshotPublisher&) = delete;
+    SharedSnapshotPublisher& operator=(const SharedSnapshotPublisher&) = delete;
+
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief publish   Записать снимок. Один писатель на сегмент
+     */
+    void publish(const StatusSnapshot& snapshot) noexcept;
+
+private:
+    std::string m_segmentName;
+    int m_fd {-1};  // Holds the publisher lock
+    SharedSnapshotSegment* m_pSegment {nullptr};
+};
+
+/**
+ * @brief The SharedSnapshotReader class   Чтение снимков, опубликованных SharedSnapshotPublisher.
+ *                                          Сегмент отображается только для чтения
+ */
+class SharedSnapshotReader
+{
+public:
+    explicit SharedSnapshotReader(const std::string& segmentName = SharedSnapshotPublisher::DEFAULT_SEGMENT_NAME);
+    ~SharedSnapshotReader();
+
+    SharedSnapshotReader(const SharedSnapshotReader&) = delete;
+    SharedSnapshotReader& operator=(const SharedSnapshotReader&) = delete;
+
+    /**
+     * @brief open  Открыть сегмент. Нужно повторять, пока издатель не запущен
+     */
+    bool open();
+    bool isOpened() const noexcept;
+
+    /**
+     * @brief sequence  Номер последней публикации, 0 — данных ещё нет
+     */
+    uint64_t sequence() const noexcept;
+
+    /**
+     * @brief read  Скопировать согласованный снимок. Число попыток ограничено: если издатель завершился посреди
+     *              записи, вызов не зависает, а возвращает false (isStale() при этом true)
+     * @return  false, если сегмент не открыт, данных ещё нет, издатель остановлен или запись не закончилась
+     *          за отведённые попытки
+     */
+    bool read(StatusSnapshot& oSnapshot) const noexcept;
+
+    /**
+     * @brief isStale   Издатель остановлен, его процесс завершился или сегмент занял новый издатель.
+     *                  Нужно снова вызвать open()
+     */
+    bool isStale() const noexcept;
+
+private:
+    std::string m_segmentName;
+    const SharedSnapshotSegment* m_pSegment {nullptr};
+    uint64_t m_generation {0};
+
+    void close() noexcept;
+};
+
+} // namespace SystemProcessing
@@ -1,64 +1,491 @@
 #include "statusmanager.hpp"
+#include "asyncstatus.hpp"
+#include "cgroupreader.hpp"
+#include "collectoroptions.hpp"
+#include "procstatreader.hpp"
+#include "hwmonregistry.hpp"
+#include "meminforeader.hpp"
+#include "numatopology.hpp"
+#include "perfcounters.hpp"
+#include "raplreader.hpp"
+#include "metrichistory.hpp"
+#include "pressuremonitor.hpp"
+#include "sharedsnapshot.hpp"
+#include "thresholdevaluator.hpp"
 
 #include <Components/Logger/Logger.h>
-#include <Components/Filework/Common.h>
 
 #include <algorithm>
-#include <numeric>
-#include <regex>
 
 #include <sys/sysinfo.h>
 
-#include <fstream>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 namespace SystemProcessing {
 
-double StatusManager::getCPUCurrentTemperature() const noexcept
+namespace
+{
+
+bool calculateCoresLoad(const CPUTimesTable& prev, const CPUTimesTable& cur, StatusSnapshot& oSnapshot) noexcept
+{
+    if (prev.coreIds != cur.coreIds) {
+        oSnapshot.coreCount = 0;
+        return false;
+    }
+
+    const size_t count = std::min(cur.coreCount(), StatusSnapshot::MAX_CORES);
+    oSnapshot.coreCount = count;
+    std::copy_n(cur.coreIds.begin(), count, oSnapshot.coreIds);
+    calculateCoresDeltas(prev, cur, count,
+                         oSnapshot.coreUser, oSnapshot.coreSystem, oSnapshot.coreIowait, oSnapshot.coreSteal, oSnapshot.coreIdle);
+    return true;
+}
+
+} // namespace
+
+struct StatusManager::StatusManagerPrivate
 {
-    const std::string tempDataFile = "/sys/class/hwmon/hwmon2/temp1_input";
+    static constexpr size_t CPU_TIMES_HISTORY_SIZE = 128;
+
+    struct CPUTimesSample {
+        std::atomic<uint64_t> idleTime {0};
+        std::atomic<uint64_t> totalTime {0};
+    };
+
+    // Sampler history, written by the sampler thread only and published with a seqlock
+    std::array<CPUTimesSample, CPU_TIMES_HISTORY_SIZE> cpuTimesHistory;
+    std::atomic<uint64_t> historySequence {0};
+    std::atomic<uint64_t> historyWritten {0};
+
+    std::atomic<double> lastCPULoad {0};
+
+    ProcStatReader procStat;
+
+#if SYSTEMPROCESSING_WITH_HWMON
+    HwmonRegistry hwmon;
+    const HwmonSensor* cpuTemperatureSensor {hwmon.findCPUTemperature()};
+#endif // SYSTEMPROCESSING_WITH_HWMON
+
+    bool readCPUTemperature(double& oTemperature) const noexcept
+    {
+#if SYSTEMPROCESSING_WITH_HWMON
+        return cpuTemperatureSensor != nullptr && hwmon.read(*cpuTemperatureSensor, oTemperature);
+#else
+        (void)oTemperature;
+        return false;
+#endif // SYSTEMPROCESSING_WITH_HWMON
+    }
+
+#if SYSTEMPROCESSING_WITH_PSI
+    PressureReader pressure;
+#endif // SYSTEMPROCESSING_WITH_PSI
+    MeminfoReader meminfo;
+
+    NumaTopology numa;
+
+#if SYSTEMPROCESSING_WITH_RAPL
+    mutable std::mutex raplMx;
+    RaplReader rapl;
+    RaplPower lastPower;
+    bool isPowerValid {false};
+#endif // SYSTEMPROCESSING_WITH_RAPL
+
+    bool updatePower()
+    {
+#if SYSTEMPROCESSING_WITH_RAPL
+        std::lock_guard lock(raplMx);
+        isPowerValid = rapl.read(lastPower);
+        return isPowerValid;
+#else
+        return false;
+#endif // SYSTEMPROCESSING_WITH_RAPL
+    }
+
+#if SYSTEMPROCESSING_WITH_PERF
+    // Rates between two reads: per sampler interval, or per call without the sampler
+    mutable std::mutex perfMx;
+    PerfCounters perf;
+    PerfCountersSample perfPrevSample;
+    PerfCountersSample perfSample;
+    PerfRates lastPerfRates;
+#endif // SYSTEMPROCESSING_WITH_PERF
+
+    bool updatePerfRates()
+    {
+#if SYSTEMPROCESSING_WITH_PERF
+        std::lock_guard lock(perfMx);
+        if (!perf.read(perfSample)) {
+            return false;
+        }
+        lastPerfRates = perfPrevSample.timestampNs != 0 ? PerfCounters::rates(perfPrevSample, perfSample) : PerfRates {};
+        std::swap(perfPrevSample, perfSample);
+        return true;
+#else
+        return false;
+#endif // SYSTEMPROCESSING_WITH_PERF
+    }
 
-    std::string temperatureString;
-    if (!Filework::Common::readFileData(tempDataFile, temperatureString))
+    // The agent's own cgroup; the host-wide /proc/stat and sysinfo don't see container limits
+    mutable std::mutex cgroupMx;
+    CgroupReader cgroups;
+    int selfCgroup {cgroups.isOpened() ? cgroups.addSelf() : CgroupReader::INVALID_INDEX};
+
+    // Per-core data of the last sampler interval
+    CPUTimesTable prevCoresTimes;
+    CPUTimesTable coresTimes;
+    CPUCoresLoad coresLoadScratch;
+    mutable std::mutex coresLoadMx;
+    CPUCoresLoad lastCoresLoad;
+    bool coresLoadValid {false};
+
+    // Previous snapshot() counters when the sampler is not running
+    std::mutex snapshotMx;
+    CPUTimesTable snapshotPrevTimes;
+    CPUTimesTable snapshotTimes;
+
+    // Sampler values history
+    mutable std::mutex metricHistoryMx;
+    MetricHistory cpuLoadHistory;
+    MetricHistory cpuTemperatureHistory;
+
+    ThresholdEvaluator thresholds;
+
+    // Shared with awaitables, which may outlive a call on the manager
+    std::shared_ptr<LoadMeasurementScheduler> loadScheduler {std::make_shared<LoadMeasurementScheduler>()};
+
+    std::atomic<bool> isSampling {false};
+    std::chrono::milliseconds samplingInterval {100};
+
+    // Guarded by samplerMx
+    std::unique_ptr<SharedSnapshotPublisher> publisher;
+    std::unique_ptr<MetricsExporter> exporter;
+    StatusSnapshot publishedSnapshot {};
+
+    std::thread samplerThread;
+    std::mutex samplerMx;
+    std::condition_variable samplerCv;
+    bool stopRequested {false};
+
+    explicit StatusManagerPrivate(size_t historyBudgetBytes) :
+        cpuLoadHistory {historyBudgetBytes},
+        cpuTemperatureHistory {historyBudgetBytes}
+    {
+
+    }
+
+    ~StatusManagerPrivate()
+    {
+        stopSampler();
+    }
+
+    void startSampler(std::chrono::milliseconds interval, int numaNode)
+    {
+        stopSampler();
+
+        samplingInterval = std::max(interval, std::chrono::milliseconds(1));
+        stopRequested = false;
+        historyWritten.store(0, std::memory_order_relaxed);
+        lastCPULoad.store(0, std::memory_order_relaxed);
+        prevCoresTimes.clear();
+        {
+            std::lock_guard lock(coresLoadMx);
+            coresLoadValid = false;
+        }
+
+        samplerThread = std::thread(&StatusManagerPrivate::samplerLoop, this, numaNode);
+        isSampling.store(true, std::memory_order_release);
+    }
+
+    void stopSampler()
+    {
+        if (!samplerThread.joinable()) {
+            return;
+        }
+
+        {
+            std::lock_guard lock(samplerMx);
+            stopRequested = true;
+        }
+        samplerCv.notify_all();
+        samplerThread.join();
+        isSampling.store(false, std::memory_order_release);
+    }
+
+    void samplerLoop(int numaNode)
+    {
+        // Keeps the sampler's buffers and wakeups on one socket
+        if (numaNode != NumaTopology::UNKNOWN_NODE) {
+            const auto& nodes = numa.nodes();
+            auto nodeIt = std::find_if(nodes.begin(), nodes.end(), [numaNode](auto& node) { return node.id == numaNode; });
+            if (nodeIt == nodes.end() || !numa.pinCurrentThread(nodeIt - nodes.begin())) {
+                COMPLOG_WARNING("Sampler is not pinned to NUMA node:", numaNode);
+            }
+        }
+
+        std::unique_lock lock(samplerMx);
+        while (!stopRequested)
+        {
+            if (procStat.read(coresTimes)) {
+                publishSample(coresTimes.aggregate.idle(), coresTimes.aggregate.total());
+
+                if (calculateCoresLoad(prevCoresTimes, coresTimes, coresLoadScratch)) {
+                    std::lock_guard coresLock(coresLoadMx);
+                    std::swap(lastCoresLoad, coresLoadScratch);
+                    coresLoadValid = true;
+                }
+                std::swap(prevCoresTimes, coresTimes);
+            }
+            processMetrics();
+            updatePerfRates();
+            updatePower();
+            if (publisher || exporter) {
+                fillSnapshot(publishedSnapshot, true);
+                if (publisher) {
+                    publisher->publish(publishedSnapshot);
+                }
+                if (exporter) {
+                    exporter->update(publishedSnapshot);
+                }
+            }
+            samplerCv.wait_for(lock, samplingInterval, [this]() { return stopRequested; });
+        }
+    }
+
+    bool fillSnapshot(StatusSnapshot& oSnapshot, bool useSamplerValues) noexcept;
+
+    // Feeds the sampled values to the history and threshold subscriptions
+    void processMetrics()
+    {
+        const auto timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        // The first sample has nothing to compare load with
+        const bool loadOk = historyWritten.load(std::memory_order_relaxed) > 1;
+        const double load = lastCPULoad.load(std::memory_order_relaxed);
+
+        double temperature {};
+        const bool temperatureOk = readCPUTemperature(temperature);
+
+        {
+            std::lock_guard historyLock(metricHistoryMx);
+            if (loadOk) {
+                cpuLoadHistory.insert(timestampNs, load);
+            }
+            if (temperatureOk) {
+                cpuTemperatureHistory.insert(timestampNs, temperature);
+            }
+        }
+
+        if (loadOk) {
+            thresholds.evaluate(StatusMetric::CPULoad, load, timestampNs);
+        }
+        if (temperatureOk) {
+            thresholds.evaluate(StatusMetric::CPUTemperature, temperature, timestampNs);
+        }
+    }
+
+    void publishSample(uint64_t idleTime, uint64_t totalTime)
+    {
+        const auto written = historyWritten.load(std::memory_order_relaxed);
+        if (written > 0) {
+            auto& prev = cpuTimesHistory[(written - 1) % CPU_TIMES_HISTORY_SIZE];
+            lastCPULoad.store(
+                calculateCPULoad(prev.idleTime.load(std::memory_order_relaxed),
+                              prev.totalTime.load(std::memory_order_relaxed),
+                              idleTime, totalTime),
+                std::memory_order_relaxed);
+        }
+
+        const auto seq = historySequence.load(std::memory_order_relaxed);
+        historySequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto& slot = cpuTimesHistory[written % CPU_TIMES_HISTORY_SIZE];
+        slot.idleTime.store(idleTime, std::memory_order_relaxed);
+        slot.totalTime.store(totalTime, std::memory_order_relaxed);
+        historyWritten.store(written + 1, std::memory_order_relaxed);
+
+        historySequence.store(seq + 2, std::memory_order_release);
+    }
+
+    LoadMeasurementScheduler::MeasurementPtr samplerMeasurement(std::chrono::milliseconds window) const
+    {
+        auto pMeasurement = std::make_shared<LoadMeasurement>();
+        pMeasurement->isValid = true;
+        pMeasurement->cpuLoad = loadForWindow(window);
+
+        std::lock_guard lock(coresLoadMx);
+        if (coresLoadValid) {
+            pMeasurement->coresLoad = lastCoresLoad;
+        }
+        return pMeasurement;
+    }
+
+    double loadForWindow(std::chrono::milliseconds window) const noexcept
+    {
+        const size_t steps = std::max<size_t>(1, (window + samplingInterval / 2) / samplingInterval);
+
+        uint64_t oldIdle {}, oldTotal {}, newIdle {}, newTotal {};
+        uint64_t seq {};
+        do {
+            seq = historySequence.load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+
+            const auto written = historyWritten.load(std::memory_order_relaxed);
+            if (written < 2) {
+                return lastCPULoad.load(std::memory_order_relaxed);
+            }
+
+            const auto available = std::min<uint64_t>(written, CPU_TIMES_HISTORY_SIZE) - 1;
+            const auto& newest = cpuTimesHistory[(written - 1) % CPU_TIMES_HISTORY_SIZE];
+            const auto& oldest = cpuTimesHistory[(written - 1 - std::min<uint64_t>(steps, available)) % CPU_TIMES_HISTORY_SIZE];
+            newIdle  = newest.idleTime.load(std::memory_order_relaxed);
+            newTotal = newest.totalTime.load(std::memory_order_relaxed);
+            oldIdle  = oldest.idleTime.load(std::memory_order_relaxed);
+            oldTotal = oldest.totalTime.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || seq != historySequence.load(std::memory_order_relaxed));
+
+        return calculateCPULoad(oldIdle, oldTotal, newIdle, newTotal);
+    }
+};
+
+StatusManager::StatusManager() :
+    StatusManager(DEFAULT_HISTORY_BUDGET)
+{
+
+}
+
+StatusManager::StatusManager(size_t historyBudgetBytes) :
+    d {new StatusManagerPrivate(historyBudgetBytes)}
+{
+
+}
+
+StatusManager::~StatusManager()
+{
+
+}
+
+double StatusManager::getCPUCurrentTemperature() const noexcept
+{
+    double temperature {};
+    if (!d->readCPUTemperature(temperature))
     {
         COMPLOG_WARNING("Error getting CPU temperature");
         return 0;
     }
+    return temperature;
+}
 
-    // Data in a file represented like 46 123 what mean 46,123 C degrees
-    try {
-        return std::stoi(temperatureString) / 1000.0;
-    } catch (std::invalid_argument& ex) {
-        return 0;
+const HwmonRegistry &StatusManager::getHwmonRegistry() const noexcept
+{
+#if SYSTEMPROCESSING_WITH_HWMON
+    return d->hwmon;
+#else
+    static const HwmonRegistry emptyRegistry {std::string()};
+    return emptyRegistry;
+#endif // SYSTEMPROCESSING_WITH_HWMON
+}
+
+double StatusManager::getCPULoad() const noexcept
+{
+    if (isSampling()) {
+        return d->lastCPULoad.load(std::memory_order_relaxed);
     }
+    return getCPULoad(std::chrono::milliseconds(100));
+}
 
+double StatusManager::getCPULoad(std::chrono::milliseconds window) const noexcept
+{
+    if (isSampling()) {
+        return d->loadForWindow(window);
+    }
 
-    // V2?
-    /*
-    auto tempers = exec("sensors | grep Tctl");
-    auto currentPos = std::find(tempers.begin(), tempers.end(), '+') + 1;
-    auto endPos = std::find(currentPos, tempers.end(), 'C') - 2;
-    return std::stof(std::string(currentPos, endPos));
-    */
+    CPUTimes previousTimes, times;
+    if (!d->procStat.readAggregate(previousTimes)) {
+        COMPLOG_WARNING("Error getting CPU times");
+        return 0;
+    }
+    std::this_thread::sleep_for(window);
+    if (!d->procStat.readAggregate(times)) {
+        COMPLOG_WARNING("Error getting CPU times");
+        return 0;
+    }
+    return calculateCPULoad(previousTimes.idle(), previousTimes.total(), times.idle(), times.total());
 }
 
-double StatusManager::getCPULoad() const noexcept
+bool StatusManager::getCPUCoresLoad(CPUCoresLoad &oLoad, std::chrono::milliseconds window) const
 {
-    size_t previous_idle_time=0, previous_total_time=0;
-    size_t idle_time{}, total_time{};
+    if (isSampling()) {
+        std::lock_guard lock(d->coresLoadMx);
+        if (!d->coresLoadValid) {
+            return false;
+        }
+        // Vector assignment reuses the caller's capacity
+        oLoad = d->lastCoresLoad;
+        return true;
+    }
 
-    double utilization = 0;
-    for (int i = 0; i < 2; i++)
-    {
-        getCPUtimes(idle_time, total_time);
-        const double idle_time_delta = idle_time - previous_idle_time;
-        const double total_time_delta = total_time - previous_total_time;
-        utilization = 100.0 * (1.0 - idle_time_delta / total_time_delta);
-        previous_idle_time = idle_time;
-        previous_total_time = total_time;
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CPUTimesTable prevTimes, curTimes;
+    if (!d->procStat.read(prevTimes)) {
+        COMPLOG_WARNING("Error getting CPU times");
+        return false;
     }
-    return utilization;
+    std::this_thread::sleep_for(window);
+    if (!d->procStat.read(curTimes)) {
+        COMPLOG_WARNING("Error getting CPU times");
+        return false;
+    }
+    return calculateCoresLoad(prevTimes, curTimes, oLoad);
+}
+
+void StatusManager::measureLoadAsync(std::chrono::milliseconds window, LoadMeasurementScheduler::Completion completion) const
+{
+    if (isSampling()) {
+        completion(d->samplerMeasurement(window));
+        return;
+    }
+    d->loadScheduler->measure(window, std::move(completion));
+}
+
+void StatusManager::setAsyncExecutor(LoadMeasurementScheduler::Executor executor)
+{
+    d->loadScheduler->setExecutor(std::move(executor));
+}
+
+#if SYSTEMPROCESSING_HAS_COROUTINES
+CPULoadAwaitable StatusManager::asyncCPULoad(std::chrono::milliseconds window) const
+{
+    return CPULoadAwaitable(d->loadScheduler, window, isSampling() ? d->samplerMeasurement(window) : nullptr);
+}
+
+LoadMeasurementAwaitable StatusManager::asyncLoadMeasurement(std::chrono::milliseconds window) const
+{
+    return LoadMeasurementAwaitable(d->loadScheduler, window, isSampling() ? d->samplerMeasurement(window) : nullptr);
+}
+#endif
+
+void StatusManager::startSampling(std::chrono::milliseconds interval, int numaNode)
+{
+    d->startSampler(interval, numaNode);
+}
+
+void StatusManager::stopSampling()
+{
+    d->stopSampler();
+}
+
+bool StatusManager::isSampling() const noexcept
+{
+    return d->isSampling.load(std::memory_order_acquire);
 }
 
 unsigned long long StatusManager::getUptimeSec() const
@@ -70,22 +497,352 @@ unsigned long long StatusManager::getUptimeSec() const
     return info.uptime;
 }
 
-std::vector<size_t> StatusManager::getCPUtimes() const {
-    std::ifstream proc_stat("/proc/stat");
-    proc_stat.ignore(5, ' '); // Skip the 'cpu' prefix.
-    std::vector<size_t> times;
-    for (size_t time; proc_stat >> time; times.push_back(time));
-    return times;
+const NumaTopology &StatusManager::getNumaTopology() const noexcept
+{
+    return d->numa;
+}
+
+bool StatusManager::getNumaNodesLoad(std::vector<double> &oNodesLoad, std::chrono::milliseconds window) const
+{
+    CPUCoresLoad coresLoad;
+    if (!getCPUCoresLoad(coresLoad, window)) {
+        return false;
+    }
+    d->numa.aggregateLoad(coresLoad, oNodesLoad);
+    return true;
+}
+
+bool StatusManager::startPerfCounters(const std::string &cgroupPath)
+{
+#if SYSTEMPROCESSING_WITH_PERF
+    std::lock_guard lock(d->perfMx);
+    d->perfPrevSample = {};
+    d->lastPerfRates = {};
+    return d->perf.open(cgroupPath);
+#else
+    (void)cgroupPath;
+    COMPLOG_WARNING("Perf counters are disabled by SYSTEMPROCESSING_WITH_PERF");
+    return false;
+#endif // SYSTEMPROCESSING_WITH_PERF
+}
+
+void StatusManager::stopPerfCounters()
+{
+#if SYSTEMPROCESSING_WITH_PERF
+    std::lock_guard lock(d->perfMx);
+    d->perf.close();
+    d->lastPerfRates = {};
+#endif // SYSTEMPROCESSING_WITH_PERF
+}
+
+bool StatusManager::getPerfRates(PerfRates &oRates) const
+{
+#if SYSTEMPROCESSING_WITH_PERF
+    if (!isSampling() && !d->updatePerfRates()) {
+        return false;
+    }
+    std::lock_guard lock(d->perfMx);
+    oRates = d->lastPerfRates;
+    return d->perf.isOpened();
+#else
+    (void)oRates;
+    return false;
+#endif // SYSTEMPROCESSING_WITH_PERF
+}
+
+bool StatusManager::getPowerUsage(RaplPower &oPower) const
+{
+#if SYSTEMPROCESSING_WITH_RAPL
+    if (!isSampling()) {
+        d->updatePower();
+    }
+    std::lock_guard lock(d->raplMx);
+    if (!d->isPowerValid) {
+        return false;
+    }
+    oPower = d->lastPower;
+    return true;
+#else
+    (void)oPower;
+    return false;
+#endif // SYSTEMPROCESSING_WITH_RAPL
+}
+
+bool StatusManager::getCgroupStats(CgroupStats &oStats) const
+{
+    std::lock_guard lock(d->cgroupMx);
+    return d->cgroups.read(d->selfCgroup, oStats);
+}
+
+double StatusManager::getCgroupCPULoad(std::chrono::milliseconds window) const
+{
+    CgroupStats prevStats, stats;
+    if (!getCgroupStats(prevStats)) {
+        return -1;
+    }
+    std::this_thread::sleep_for(window);
+    if (!getCgroupStats(stats)) {
+        return -1;
+    }
+    return CgroupReader::cpuLoad(prevStats, stats);
+}
+
+int StatusManager::subscribe(const ThresholdRule &rule, ThresholdCallback callback)
+{
+    return d->thresholds.subscribe(rule, std::move(callback));
+}
+
+int StatusManager::subscribe(const ThresholdRule &rule, int eventFd)
+{
+    return d->thresholds.subscribe(rule, eventFd);
+}
+
+bool StatusManager::unsubscribe(int subscriptionId)
+{
+    return d->thresholds.unsubscribe(subscriptionId);
+}
+
+bool StatusManager::isThresholdActive(int subscriptionId) const
+{
+    return d->thresholds.isActive(subscriptionId);
+}
+
+bool StatusManager::getMemoryStats(MemoryStats &oStats) const noexcept
+{
+    return d->meminfo.read(oStats);
+}
+
+bool StatusManager::getPressure(PressureResource resource, PressureReading &oReading) const noexcept
+{
+#if SYSTEMPROCESSING_WITH_PSI
+    return d->pressure.read(resource, oReading);
+#else
+    (void)resource;
+    (void)oReading;
+    return false;
+#endif // SYSTEMPROCESSING_WITH_PSI
+}
+
+bool StatusManager::queryHistory(StatusMetric metric, uint64_t fromNs, uint64_t toNs, MetricAggregate &oResult) const noexcept
+{
+    std::lock_guard lock(d->metricHistoryMx);
+    switch (metric)
+    {
+    case StatusMetric::CPULoad:         return d->cpuLoadHistory.query(fromNs, toNs, oResult);
+    case StatusMetric::CPUTemperature:  return d->cpuTemperatureHistory.query(fromNs, toNs, oResult);
+    }
+    return false;
 }
 
-bool StatusManager::getCPUtimes(size_t &idleTime, size_t &totalTime) const {
-    const std::vector<size_t> cpu_times = getCPUtimes();
-    if (cpu_times.size() < 4)
+bool StatusManager::StatusManagerPrivate::fillSnapshot(StatusSnapshot &oSnapshot, bool useSamplerValues) noexcept
+{
+    oSnapshot.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    bool cpuOk = true;
+    if (useSamplerValues) {
+        oSnapshot.cpuLoad = lastCPULoad.load(std::memory_order_relaxed);
+
+        std::lock_guard lock(coresLoadMx);
+        const auto& coresLoad = lastCoresLoad;
+        const size_t count = coresLoadValid ? std::min(coresLoad.coreCount(), StatusSnapshot::MAX_CORES) : 0;
+        oSnapshot.coreCount = count;
+        std::copy_n(coresLoad.coreIds.begin(), count, oSnapshot.coreIds);
+        std::copy_n(coresLoad.user.begin(), count, oSnapshot.coreUser);
+        std::copy_n(coresLoad.system.begin(), count, oSnapshot.coreSystem);
+        std::copy_n(coresLoad.iowait.begin(), count, oSnapshot.coreIowait);
+        std::copy_n(coresLoad.steal.begin(), count, oSnapshot.coreSteal);
+        std::copy_n(coresLoad.idle.begin(), count, oSnapshot.coreIdle);
+    } else {
+        std::lock_guard lock(snapshotMx);
+        cpuOk = procStat.read(snapshotTimes);
+        if (cpuOk) {
+            const auto& prev = snapshotPrevTimes.aggregate;
+            const auto& cur = snapshotTimes.aggregate;
+            oSnapshot.cpuLoad = prev.total() ? calculateCPULoad(prev.idle(), prev.total(), cur.idle(), cur.total()) : 0;
+            calculateCoresLoad(snapshotPrevTimes, snapshotTimes, oSnapshot);
+            std::swap(snapshotPrevTimes, snapshotTimes);
+        } else {
+            oSnapshot.cpuLoad = 0;
+            oSnapshot.coreCount = 0;
+        }
+    }
+
+    oSnapshot.cpuTemperature = 0;
+    oSnapshot.temperatureCount = 0;
+#if SYSTEMPROCESSING_WITH_HWMON
+    const auto& sensors = hwmon.sensors();
+    for (size_t i = 0; i < sensors.size() && oSnapshot.temperatureCount < StatusSnapshot::MAX_TEMPERATURES; ++i) {
+        double temperature {};
+        if (sensors[i].type != SensorType::Temperature || !hwmon.read(sensors[i], temperature)) {
+            continue;
+        }
+        if (&sensors[i] == cpuTemperatureSensor) {
+            oSnapshot.cpuTemperature = temperature;
+        }
+        auto& entry = oSnapshot.temperatures[oSnapshot.temperatureCount++];
+        entry.sensorIndex = i;
+        entry.celsius = temperature;
+    }
+#endif // SYSTEMPROCESSING_WITH_HWMON
+
+    struct sysinfo info;
+    if (sysinfo(&info) == 0) {
+        oSnapshot.memoryTotal   = uint64_t(info.totalram) * info.mem_unit;
+        oSnapshot.memoryFree    = uint64_t(info.freeram) * info.mem_unit;
+        oSnapshot.memoryShared  = uint64_t(info.sharedram) * info.mem_unit;
+        oSnapshot.memoryBuffers = uint64_t(info.bufferram) * info.mem_unit;
+        oSnapshot.swapTotal     = uint64_t(info.totalswap) * info.mem_unit;
+        oSnapshot.swapFree      = uint64_t(info.freeswap) * info.mem_unit;
+        oSnapshot.uptimeSec     = info.uptime;
+        for (size_t i = 0; i < 3; ++i) {
+            oSnapshot.loadAverage[i] = info.loads[i] / double(1 << SI_LOAD_SHIFT);
+        }
+        oSnapshot.processCount  = info.procs;
+    } else {
+        COMPLOG_WARNING("Error getting sysinfo");
+    }
+
+    MemoryStats memoryStats;
+    if (!meminfo.read(memoryStats)) {
+        memoryStats = {};
+    }
+    oSnapshot.memoryAvailable = memoryStats.available;
+    oSnapshot.memoryCached    = memoryStats.cached;
+    oSnapshot.memoryDirty     = memoryStats.dirty;
+
+    for (size_t i = 0; i < 3; ++i) {
+        PressureReading reading {};
+#if SYSTEMPROCESSING_WITH_PSI
+        if (!pressure.read(static_cast<PressureResource>(i), reading)) {
+            reading = {};
+        }
+#endif // SYSTEMPROCESSING_WITH_PSI
+        oSnapshot.pressureSomeAvg10[i] = reading.some.avg10;
+        oSnapshot.pressureFullAvg10[i] = reading.full.avg10;
+    }
+
+    const auto& nodes = numa.nodes();
+    oSnapshot.numaNodeCount = std::min(nodes.size(), StatusSnapshot::MAX_NUMA_NODES);
+    uint32_t nodeCoresCount[StatusSnapshot::MAX_NUMA_NODES] {};
+    for (size_t i = 0; i < oSnapshot.numaNodeCount; ++i) {
+        auto& entry = oSnapshot.numaNodes[i];
+        entry.nodeId = nodes[i].id;
+        entry.load = 0;
+
+        NodeMemoryStats nodeMemory;
+        if (!numa.readMemory(i, nodeMemory)) {
+            nodeMemory = {};
+        }
+        entry.memoryTotal = nodeMemory.total;
+        entry.memoryFree  = nodeMemory.free;
+    }
+    for (size_t i = 0; i < oSnapshot.coreCount; ++i) {
+        const int node = numa.nodeIndex(oSnapshot.coreIds[i]);
+        if (node >= 0 && static_cast<size_t>(node) < oSnapshot.numaNodeCount) {
+            oSnapshot.numaNodes[node].load += 100.0f - oSnapshot.coreIdle[i];
+            ++nodeCoresCount[node];
+        }
+    }
+    for (size_t i = 0; i < oSnapshot.numaNodeCount; ++i) {
+        if (nodeCoresCount[i] != 0) {
+            oSnapshot.numaNodes[i].load /= nodeCoresCount[i];
+        }
+    }
+
+#if SYSTEMPROCESSING_WITH_PERF
+    if (!useSamplerValues) {
+        updatePerfRates();
+    }
+    {
+        std::lock_guard lock(perfMx);
+        oSnapshot.ipc                   = lastPerfRates.ipc;
+        oSnapshot.contextSwitchesPerSec = lastPerfRates.contextSwitchesPerSec;
+        oSnapshot.pageFaultsPerSec      = lastPerfRates.pageFaultsPerSec;
+        oSnapshot.cacheMissesPerSec     = lastPerfRates.cacheMissesPerSec;
+    }
+#else
+    oSnapshot.ipc                   = 0;
+    oSnapshot.contextSwitchesPerSec = 0;
+    oSnapshot.pageFaultsPerSec      = 0;
+    oSnapshot.cacheMissesPerSec     = 0;
+#endif // SYSTEMPROCESSING_WITH_PERF
+
+#if SYSTEMPROCESSING_WITH_RAPL
+    if (!useSamplerValues) {
+        updatePower();
+    }
+    {
+        std::lock_guard lock(raplMx);
+        oSnapshot.cpuPackageWatts = isPowerValid ? lastPower.packageWatts : 0;
+        oSnapshot.cpuCoreWatts    = isPowerValid ? lastPower.coreWatts : 0;
+        oSnapshot.dramWatts       = isPowerValid ? lastPower.dramWatts : 0;
+    }
+#else
+    oSnapshot.cpuPackageWatts = 0;
+    oSnapshot.cpuCoreWatts    = 0;
+    oSnapshot.dramWatts       = 0;
+#endif // SYSTEMPROCESSING_WITH_RAPL
+
+    return cpuOk;
+}
+
+bool StatusManager::snapshot(StatusSnapshot &oSnapshot) const noexcept
+{
+    return d->fillSnapshot(oSnapshot, isSampling());
+}
+
+bool StatusManager::startPublishing(const std::string &segmentName)
+{
+    // The previous publisher holds the segment lock, it has to go first
+    stopPublishing();
+
+    auto pPublisher = std::make_unique<SharedSnapshotPublisher>(segmentName);
+    if (!pPublisher->isOpened()) {
         return false;
-    idleTime = cpu_times[3];
-    totalTime = std::accumulate(cpu_times.begin(), cpu_times.end(), 0);
+    }
+
+    std::lock_guard lock(d->samplerMx);
+    d->publisher = std::move(pPublisher);
     return true;
 }
 
+void StatusManager::stopPublishing()
+{
+    std::lock_guard lock(d->samplerMx);
+    d->publisher.reset();
+}
+
+bool StatusManager::startExporter(const std::string &address)
+{
+    // Labels are built once here, scrapes only copy them
+    std::vector<std::string> sensorLabels;
+    for (auto& sensor : getHwmonRegistry().sensors()) {
+        const auto sensorName = sensor.label.empty() ? "temp" + std::to_string(sensor.index) : sensor.label;
+        sensorLabels.push_back("chip=\"" + MetricsExporter::escapeLabelValue(sensor.chipName)
+                               + "\",sensor=\"" + MetricsExporter::escapeLabelValue(sensorName) + "\"");
+    }
+
+    // The previous exporter may hold the same port or socket path, so it closes first
+    stopExporter();
+
+    auto pExporter = std::make_unique<MetricsExporter>(address, std::move(sensorLabels));
+    if (!pExporter->isOpened()) {
+        return false;
+    }
+
+    std::lock_guard lock(d->samplerMx);
+    d->exporter = std::move(pExporter);
+    return true;
+}
+
+void StatusManager::stopExporter()
+{
+    std::unique_ptr<MetricsExporter> pExporter;
+    {
+        std::lock_guard lock(d->samplerMx);
+        std::swap(d->exporter, pExporter);
+    }
+}
 
 } // namespace SystemProcessing
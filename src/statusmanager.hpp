@@ -1,33 +1,230 @@
 #pragma once
 
+#include "asyncstatus.hpp"
+#include "cgroupreader.hpp"
+#include "metricsexporter.hpp"
+#include "numatopology.hpp"
+#include "perfcounters.hpp"
+#include "raplreader.hpp"
+#include "procstatreader.hpp"
+#include "sharedsnapshot.hpp"
+#include "statussnapshot.hpp"
+#include "thresholdevaluator.hpp"
+
 #include <stdint.h>
 #include <string>
 
+#include <chrono>
+#include <memory>
 #include <vector>
 
 namespace SystemProcessing {
 
+class HwmonRegistry;
+struct MetricAggregate;
+struct PressureReading;
+struct MemoryStats;
+enum class PressureResource : uint8_t;
+
+
 class StatusManager
 {
 public:
+    static constexpr size_t DEFAULT_HISTORY_BUDGET = 64 * 1024;
+
+    StatusManager();
+
+    /**
+     * @brief StatusManager         Создать менеджер
+     * @param historyBudgetBytes    Объём памяти на историю каждой метрики (см. MetricHistory)
+     */
+    explicit StatusManager(size_t historyBudgetBytes);
+    ~StatusManager();
+
     /**
      * @brief getCPUCurrentTemperature  Получить температуру в градусах Цельсия
      * @return
      */
     double getCPUCurrentTemperature() const noexcept;
 
+    /**
+     * @brief getHwmonRegistry  Все датчики hwmon (температуры, вентиляторы, мощность). Пустой без SYSTEMPROCESSING_WITH_HWMON
+     */
+    const HwmonRegistry& getHwmonRegistry() const noexcept;
+
     /**
      * @brief getCPULoad
      * @return  Загруженность в процентах
+     * @note    При запущенном сэмплере возвращает последнее опубликованное значение без ожидания
      */
     double getCPULoad() const noexcept;
 
+    /**
+     * @brief getCPULoad    Загруженность, усреднённая за окно
+     * @param window        Окно усреднения. При запущенном сэмплере считается по истории замеров,
+     *                      иначе вызов блокируется на время окна
+     * @return  Загруженность в процентах
+     */
+    double getCPULoad(std::chrono::milliseconds window) const noexcept;
+
+    /**
+     * @brief getCPUCoresLoad   Загруженность каждого ядра по режимам (одно чтение /proc/stat на замер)
+     * @param oLoad             Результат. Переиспользуется между вызовами, чтобы не выделять память
+     * @param window            Окно замера для блокирующего режима. При запущенном сэмплере
+     *                          возвращается последний интервал сэмплера без ожидания
+     * @return  false, если данные получить не удалось
+     */
+    bool getCPUCoresLoad(CPUCoresLoad& oLoad, std::chrono::milliseconds window = std::chrono::milliseconds(100)) const;
+
+    /**
+     * @brief measureLoadAsync  Замер загрузки без блокировки: completion вызывается по окончании окна.
+     *                          Одновременные запросы с одинаковым окном обслуживаются одним замером
+     */
+    void measureLoadAsync(std::chrono::milliseconds window, LoadMeasurementScheduler::Completion completion) const;
+
+    /**
+     * @brief setAsyncExecutor  Где вызывать completion и продолжать корутины. По умолчанию — в потоке таймера
+     */
+    void setAsyncExecutor(LoadMeasurementScheduler::Executor executor);
+
+#if SYSTEMPROCESSING_HAS_COROUTINES
+    /**
+     * @brief asyncCPULoad  co_await-версия getCPULoad(window). При запущенном сэмплере возвращает результат сразу
+     */
+    CPULoadAwaitable asyncCPULoad(std::chrono::milliseconds window = std::chrono::milliseconds(100)) const;
+
+    /**
+     * @brief asyncLoadMeasurement  co_await-версия замера общей и поядерной загрузки
+     */
+    LoadMeasurementAwaitable asyncLoadMeasurement(std::chrono::milliseconds window = std::chrono::milliseconds(100)) const;
+#endif
+
+    /**
+     * @brief getNumaTopology   Узлы NUMA и их процессоры
+     */
+    const NumaTopology& getNumaTopology() const noexcept;
+
+    /**
+     * @brief getNumaNodesLoad  Загруженность каждого узла NUMA (среднее по его ядрам), по индексам getNumaTopology().nodes()
+     * @param window            Окно замера для блокирующего режима, как в getCPUCoresLoad
+     */
+    bool getNumaNodesLoad(std::vector<double>& oNodesLoad, std::chrono::milliseconds window = std::chrono::milliseconds(100)) const;
+
+    /**
+     * @brief startSampling Запустить фоновый опрос /proc/stat
+     * @param interval      Период опроса
+     * @param numaNode      Узел NUMA, к процессорам которого привязать поток сэмплера. UNKNOWN_NODE — без привязки
+     */
+    void startSampling(std::chrono::milliseconds interval = std::chrono::milliseconds(100),
+                       int numaNode = NumaTopology::UNKNOWN_NODE);
+
+    /**
+     * @brief stopSampling  Остановить фоновый опрос. getCPULoad() снова становится блокирующим
+     */
+    void stopSampling();
+
+    bool isSampling() const noexcept;
+
+    /**
+     * @brief queryHistory  Свёртка значений метрики за интервал по истории сэмплера
+     * @param fromNs, toNs  Границы интервала по CLOCK_MONOTONIC
+     * @return  false, если за интервал нет данных
+     */
+    bool queryHistory(StatusMetric metric, uint64_t fromNs, uint64_t toNs, MetricAggregate& oResult) const noexcept;
+
+    /**
+     * @brief subscribe Подписаться на переходы порога. Условия проверяются сэмплером на каждом такте,
+     *                  обработчик вызывается в его потоке. Без startSampling() событий не будет
+     * @return  Идентификатор подписки
+     */
+    int subscribe(const ThresholdRule& rule, ThresholdCallback callback);
+
+    /**
+     * @brief subscribe Подписка через eventfd: на каждый переход в него пишется 1
+     */
+    int subscribe(const ThresholdRule& rule, int eventFd);
+
+    bool unsubscribe(int subscriptionId);
+    bool isThresholdActive(int subscriptionId) const;
+
     unsigned long long getUptimeSec() const;
 
+    /**
+     * @brief startPerfCounters Открыть счётчики perf (см. PerfCounters) для snapshot() и getPerfRates()
+     * @param cgroupPath        Полный путь группы cgroup v2, пустой — вся система
+     * @return  false без прав на perf_event_open или без SYSTEMPROCESSING_WITH_PERF
+     */
+    bool startPerfCounters(const std::string& cgroupPath = {});
+    void stopPerfCounters();
+
+    /**
+     * @brief getPerfRates  IPC, переключения контекста и страничные ошибки в секунду.
+     *                      При запущенном сэмплере — за его последний интервал, иначе — с предыдущего вызова
+     * @return  false, если счётчики не открыты
+     */
+    bool getPerfRates(PerfRates& oRates) const;
+
+    /**
+     * @brief getPowerUsage Мощность процессора и памяти по RAPL. При запущенном сэмплере — за его последний интервал,
+     *                      иначе — с предыдущего вызова
+     * @return  false без RAPL, без прав на energy_uj или без SYSTEMPROCESSING_WITH_RAPL
+     */
+    bool getPowerUsage(RaplPower& oPower) const;
+
+    /**
+     * @brief getCgroupStats    Процессор, память и ввод-вывод группы cgroup v2 текущего процесса
+     * @return  false вне cgroup v2
+     */
+    bool getCgroupStats(CgroupStats& oStats) const;
+
+    /**
+     * @brief getCgroupCPULoad  Загруженность группы процесса в процентах от её квоты cpu.max
+     *                          (или от доступных процессоров без квоты). Вызов блокируется на время окна
+     * @return  Загруженность или отрицательное значение вне cgroup v2
+     */
+    double getCgroupCPULoad(std::chrono::milliseconds window = std::chrono::milliseconds(100)) const;
+
+    /**
+     * @brief getMemoryStats    Статистика памяти из /proc/meminfo (одно чтение)
+     */
+    bool getMemoryStats(MemoryStats& oStats) const noexcept;
+
+    /**
+     * @brief getPressure   Pressure Stall Information ресурса (системный уровень)
+     * @return  false, если ядро собрано без PSI, или без SYSTEMPROCESSING_WITH_PSI
+     */
+    bool getPressure(PressureResource resource, PressureReading& oReading) const noexcept;
+
+    /**
+     * @brief snapshot  Заполнить все метрики за один проход (одно чтение /proc/stat, один sysinfo)
+     * @param oSnapshot Результат, память не выделяется
+     * @note    Загруженность считается от предыдущего вызова snapshot(), первый вызов вернёт 0.
+     *          При запущенном сэмплере берутся его последние значения
+     * @return  false, если не удалось получить данные процессора
+     */
+    bool snapshot(StatusSnapshot& oSnapshot) const noexcept;
+
+    /**
+     * @brief startPublishing   Публиковать снимок в разделяемую память на каждом такте сэмплера.
+     *                          Читать его из других процессов можно через SharedSnapshotReader
+     * @param segmentName       Имя сегмента shm_open
+     * @return  false, если сегмент не удалось создать или его публикует другой процесс
+     */
+    bool startPublishing(const std::string& segmentName = SharedSnapshotPublisher::DEFAULT_SEGMENT_NAME);
+    void stopPublishing();
+
+    /**
+     * @brief startExporter Отдавать снимок каждого такта сэмплера в формате OpenMetrics для Prometheus.
+     *                      Запросы не читают /proc и /sys и не запускают замеры; без startSampling метрики не обновляются
+     * @param address       "127.0.0.1:9464" или "unix:/run/systemprocessing.sock". Прежний экспортёр закрывается
+     * @return  false, если сокет не удалось открыть
+     */
+    bool startExporter(const std::string& address = MetricsExporter::DEFAULT_ADDRESS);
+    void stopExporter();
+
 private:
-    std::vector<size_t> getCPUtimes() const;
-    bool getCPUtimes(size_t &idleTime, size_t &totalTime) const;
+    struct StatusManagerPrivate;
+    std::shared_ptr<StatusManagerPrivate> d;
 };
 
 } // namespace SystemProcessing
-
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <type_traits>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The StatusMetric enum Метрики, которые сэмплер ведёт в истории и проверяет на пороги
+ */
+enum class StatusMetric : uint8_t {
+    CPULoad,
+    CPUTemperature
+};
+
+constexpr size_t STATUS_METRICS_COUNT = 2;
+
+/**
+ * @brief The StatusSnapshot struct    Все метрики StatusManager за один проход.
+ *                                      POD фиксированного размера: можно переиспользовать между замерами
+ *                                      и копировать как есть
+ */
+struct StatusSnapshot
+{
+    static constexpr size_t MAX_CORES = 256;
+    static constexpr size_t MAX_TEMPERATURES = 32;
+    static constexpr size_t MAX_NUMA_NODES = 16;
+
+    uint64_t timestampNs;       // CLOCK_MONOTONIC
+
+    // CPU load in percents since the previous snapshot (or the last sampler interval)
+    double cpuLoad;
+    uint32_t coreCount;
+    uint32_t coreIds[MAX_CORES];
+    float coreUser[MAX_CORES];
+    float coreSystem[MAX_CORES];
+    float coreIowait[MAX_CORES];
+    float coreSteal[MAX_CORES];
+    float coreIdle[MAX_CORES];
+
+    // Celsius, sensorIndex points into HwmonRegistry::sensors()
+    double cpuTemperature;
+    uint32_t temperatureCount;
+    struct {
+        uint32_t sensorIndex;
+        float celsius;
+    } temperatures[MAX_TEMPERATURES];
+
+    // Bytes
+    uint64_t memoryTotal;
+    uint64_t memoryFree;
+    uint64_t memoryShared;
+    uint64_t memoryBuffers;
+    uint64_t memoryAvailable;   // MemAvailable from /proc/meminfo
+    uint64_t memoryCached;
+    uint64_t memoryDirty;
+    uint64_t swapTotal;
+    uint64_t swapFree;
+
+    uint64_t uptimeSec;
+    double loadAverage[3];      // 1, 5, 15 minutes
+    uint32_t processCount;
+
+    // PSI avg10 in percents, indexed by PressureResource (cpu, memory, io). Zero without CONFIG_PSI
+    double pressureSomeAvg10[3];
+    double pressureFullAvg10[3];
+
+    // Per NUMA node in NumaTopology::nodes() order. Load is the average of the node's cores in percents
+    uint32_t numaNodeCount;
+    struct {
+        int32_t nodeId;
+        float load;
+        uint64_t memoryTotal;   // Bytes, zero when the node has no meminfo
+        uint64_t memoryFree;
+    } numaNodes[MAX_NUMA_NODES];
+
+    // perf counters since the previous snapshot (or sampler interval). Zero until StatusManager::startPerfCounters(),
+    // ipc and cacheMissesPerSec also stay zero without hardware PMU
+    double ipc;
+    double contextSwitchesPerSec;
+    double pageFaultsPerSec;
+    double cacheMissesPerSec;
+
+    // RAPL watts summed over all packages, zero where the domain is missing or energy_uj is not readable
+    double cpuPackageWatts;
+    double cpuCoreWatts;
+    double dramWatts;
+};
+
+static_assert(std::is_trivially_copyable_v<StatusSnapshot> && std::is_standard_layout_v<StatusSnapshot>,
+              "StatusSnapshot must stay a POD");
+
+} // namespace SystemProcessing
@@ -0,0 +1,258 @@
+#include "sysfsbatchreader.hpp"
+#include "probestats.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(SYSTEMPROCESSING_USE_IO_URING) && __has_include(<liburing.h>)
+#include <liburing.h>
+#define SYSTEMPROCESSING_HAS_IO_URING 1
+#else
+#define SYSTEMPROCESSING_HAS_IO_URING 0
+#endif
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Upper bound of the submission queue; larger batches are sent in several rounds
+constexpr unsigned URING_MAX_ENTRIES = 1024;
+
+bool isTrailingSpace(char c) noexcept
+{
+    return c == '\n' || c == ' ' || c == '\t' || c == '\0';
+}
+
+} // namespace
+
+#if SYSTEMPROCESSING_HAS_IO_URING
+struct SysfsBatchReader::UringState
+{
+    io_uring ring {};
+    unsigned entries {0};
+    bool isUnsupported {false};
+
+    ~UringState()
+    {
+        if (entries != 0) {
+            io_uring_queue_exit(&ring);
+        }
+    }
+
+    // The ring is sized for the batch on first use and only grows afterwards
+    bool prepare(size_t batchSize) noexcept
+    {
+        if (isUnsupported) {
+            return false;
+        }
+
+        unsigned wanted = 8;
+        while (wanted < batchSize && wanted < URING_MAX_ENTRIES) {
+            wanted *= 2;
+        }
+        if (wanted <= entries) {
+            return true;
+        }
+
+        if (entries != 0) {
+            io_uring_queue_exit(&ring);
+            entries = 0;
+        }
+
+        const int result = io_uring_queue_init(wanted, &ring, 0);
+        if (result < 0) {
+            // Old kernel, seccomp or io_uring_disabled sysctl: stay on pread from now on
+            COMPLOG_WARNING("io_uring is unavailable, falling back to pread:", strerror(-result));
+            isUnsupported = true;
+            return false;
+        }
+        entries = wanted;
+        return true;
+    }
+};
+#else
+struct SysfsBatchReader::UringState {};
+#endif // SYSTEMPROCESSING_HAS_IO_URING
+
+SysfsBatchReader::SysfsBatchReader() :
+    m_uring{new UringState}
+{
+
+}
+
+SysfsBatchReader::~SysfsBatchReader()
+{
+    clear();
+}
+
+size_t SysfsBatchReader::add(const std::string &path, size_t capacity)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return INVALID_SLOT;
+    }
+
+    Slot slot;
+    slot.fd = fd;
+    slot.offset = m_arena.size();
+    slot.capacity = std::max<size_t>(capacity, 1);
+    m_arena.resize(m_arena.size() + slot.capacity);
+
+    m_slots.push_back(slot);
+    return m_slots.size() - 1;
+}
+
+void SysfsBatchReader::clear() noexcept
+{
+    for (auto& slot : m_slots) {
+        ::close(slot.fd);
+    }
+    m_slots.clear();
+    m_arena.clear();
+}
+
+size_t SysfsBatchReader::size() const noexcept
+{
+    return m_slots.size();
+}
+
+bool SysfsBatchReader::readAll() noexcept
+{
+    if (m_slots.empty()) {
+        return true;
+    }
+
+    SYSTEMPROCESSING_PROBE(probe, "sysfs.batch");
+    bool isAllRead = false;
+#if SYSTEMPROCESSING_HAS_IO_URING
+    if (m_uring->prepare(m_slots.size())) {
+        isAllRead = readAllUring();
+    } else {
+        isAllRead = readAllPread();
+    }
+#else
+    isAllRead = readAllPread();
+#endif // SYSTEMPROCESSING_HAS_IO_URING
+
+    for (auto& slot : m_slots) {
+        probe.addBytes(slot.length);
+    }
+    if (!isAllRead) {
+        probe.fail();
+    }
+    return isAllRead;
+}
+
+bool SysfsBatchReader::isValid(size_t slot) const noexcept
+{
+    return slot < m_slots.size() && m_slots[slot].length >= 0;
+}
+
+std::string_view SysfsBatchReader::value(size_t slot) const noexcept
+{
+    if (!isValid(slot)) {
+        return {};
+    }
+
+    const auto& rSlot = m_slots[slot];
+    std::string_view result(m_arena.data() + rSlot.offset, static_cast<size_t>(rSlot.length));
+    while (!result.empty() && isTrailingSpace(result.back())) {
+        result.remove_suffix(1);
+    }
+    return result;
+}
+
+bool SysfsBatchReader::value(size_t slot, int64_t &oValue) const noexcept
+{
+    const auto text = value(slot);
+    if (text.empty()) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), oValue);
+    return ec == std::errc();
+}
+
+bool SysfsBatchReader::isUsingIoUring() const noexcept
+{
+#if SYSTEMPROCESSING_HAS_IO_URING
+    return !m_uring->isUnsupported;
+#else
+    return false;
+#endif // SYSTEMPROCESSING_HAS_IO_URING
+}
+
+bool SysfsBatchReader::readAllUring() noexcept
+{
+#if SYSTEMPROCESSING_HAS_IO_URING
+    auto& ring = m_uring->ring;
+    bool isAllRead = true;
+
+    for (size_t first = 0; first < m_slots.size(); first += m_uring->entries) {
+        const size_t last = std::min(m_slots.size(), first + m_uring->entries);
+
+        for (size_t i = first; i < last; ++i) {
+            auto& slot = m_slots[i];
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            io_uring_prep_read(sqe, slot.fd, m_arena.data() + slot.offset, static_cast<unsigned>(slot.capacity), 0);
+            sqe->user_data = i;
+        }
+
+        const unsigned expected = static_cast<unsigned>(last - first);
+        const int submitted = io_uring_submit_and_wait(&ring, expected);
+        if (submitted < 0) {
+            COMPLOG_WARNING("io_uring submit failed, falling back to pread:", strerror(-submitted));
+            m_uring->isUnsupported = true;
+            return readAllPread();
+        }
+
+        for (unsigned reaped = 0; reaped < expected; ++reaped) {
+            io_uring_cqe* cqe = nullptr;
+            if (io_uring_wait_cqe(&ring, &cqe) < 0) {
+                return false;
+            }
+
+            auto& slot = m_slots[cqe->user_data];
+            const int result = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+
+            // IORING_OP_READ appeared in 5.6; earlier kernels reject the opcode itself
+            if (result == -EINVAL || result == -EOPNOTSUPP) {
+                isAllRead = readSlotPread(slot) && isAllRead;
+                continue;
+            }
+            slot.length = result;
+            isAllRead = isAllRead && result >= 0;
+        }
+    }
+    return isAllRead;
+#else
+    return readAllPread();
+#endif // SYSTEMPROCESSING_HAS_IO_URING
+}
+
+bool SysfsBatchReader::readAllPread() noexcept
+{
+    bool isAllRead = true;
+    for (auto& slot : m_slots) {
+        isAllRead = readSlotPread(slot) && isAllRead;
+    }
+    return isAllRead;
+}
+
+bool SysfsBatchReader::readSlotPread(Slot &slot) noexcept
+{
+    // sysfs regenerates the attribute on a read from offset 0, so no lseek or reopen is needed
+    const auto readBytes = ::pread(slot.fd, m_arena.data() + slot.offset, slot.capacity, 0);
+    slot.length = readBytes;
+    return readBytes >= 0;
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The SysfsBatchReader class    Пакетное чтение множества мелких файлов sysfs/procfs за один проход.
+ *                                      Файлы открываются один раз при добавлении, содержимое читается
+ *                                      в общий заранее выделенный буфер. При сборке с liburing все чтения
+ *                                      отправляются одним пакетом io_uring, иначе — циклом pread
+ */
+class SysfsBatchReader
+{
+public:
+    static constexpr size_t INVALID_SLOT = SIZE_MAX;
+    static constexpr size_t DEFAULT_SLOT_CAPACITY = 4096; // Атрибут sysfs не больше страницы
+
+    SysfsBatchReader();
+    ~SysfsBatchReader();
+
+    SysfsBatchReader(const SysfsBatchReader&) = delete;
+    SysfsBatchReader& operator=(const SysfsBatchReader&) = delete;
+
+    /**
+     * @brief add       Добавить файл в пакет. Ранее полученные string_view становятся недействительными
+     * @param capacity  Сколько байт файла читать
+     * @return  Номер слота или INVALID_SLOT, если файл не удалось открыть
+     */
+    size_t add(const std::string& path, size_t capacity = DEFAULT_SLOT_CAPACITY);
+
+    /**
+     * @brief clear Закрыть все файлы и освободить слоты
+     */
+    void clear() noexcept;
+
+    size_t size() const noexcept;
+
+    /**
+     * @brief readAll   Перечитать все файлы пакета
+     * @return  false, если хотя бы один файл не прочитан (его слот становится невалидным)
+     */
+    bool readAll() noexcept;
+
+    bool isValid(size_t slot) const noexcept;
+
+    /**
+     * @brief value Содержимое слота после последнего readAll без завершающих пробелов и переводов строки.
+     *              Указывает в буфер читателя и действительно до следующего readAll или add
+     */
+    std::string_view value(size_t slot) const noexcept;
+
+    /**
+     * @brief value Содержимое слота как целое число
+     * @return  false, если слот невалиден или не начинается с числа
+     */
+    bool value(size_t slot, int64_t& oValue) const noexcept;
+
+    /**
+     * @brief isUsingIoUring    Используется ли io_uring (false — сборка без liburing или ядро его не поддерживает)
+     */
+    bool isUsingIoUring() const noexcept;
+
+private:
+    struct Slot {
+        int fd {-1};
+        size_t offset {0};
+        size_t capacity {0};
+        int64_t length {-1};    // Отрицательное значение — ошибка последнего чтения
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<char> m_arena;
+
+    struct UringState;
+    std::unique_ptr<UringState> m_uring;
+
+    bool readAllUring() noexcept;
+    bool readAllPread() noexcept;
+    bool readSlotPread(Slot& slot) noexcept;
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,301 @@
+#include "sysfsrecorder.hpp"
+#include "cgroupreader.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <string_view>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+// Back links of sysfs devices: following them walks the whole device tree
+constexpr std::string_view SKIPPED_NAMES[] {
+    "subsystem",
+    "driver",
+    "power",
+    "firmware_node",
+    "iommu",
+    "iommu_group",
+};
+
+bool isSkipped(std::string_view name) noexcept
+{
+    if (name == "." || name == "..") {
+        return true;
+    }
+    return std::find(std::begin(SKIPPED_NAMES), std::end(SKIPPED_NAMES), name) != std::end(SKIPPED_NAMES);
+}
+
+bool makeDirectories(const std::string& dirPath)
+{
+    for (size_t separatorPos = 1; separatorPos != std::string::npos; ) {
+        separatorPos = dirPath.find('/', separatorPos + 1);
+        const auto parentPath = dirPath.substr(0, separatorPos);
+        if (::mkdir(parentPath.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Truncates and rewrites the target in place, so fds already open on it see the new contents
+ */
+bool copyFile(const std::string& sourcePath, const std::string& targetPath, std::vector<char>& buffer)
+{
+    const int sourceFd = ::open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+    if (sourceFd < 0) {
+        return false;
+    }
+    size_t readTotal = 0;
+    bool isRead = true;
+    while (readTotal < buffer.size()) {
+        const auto readBytes = ::read(sourceFd, buffer.data() + readTotal, buffer.size() - readTotal);
+        if (readBytes < 0) {
+            isRead = false;
+            break;
+        }
+        if (readBytes == 0) {
+            break;
+        }
+        readTotal += readBytes;
+    }
+    ::close(sourceFd);
+    if (!isRead) {
+        return false;
+    }
+
+    const int targetFd = ::open(targetPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (targetFd < 0) {
+        return false;
+    }
+    const bool isWritten = ::write(targetFd, buffer.data(), readTotal) == static_cast<ssize_t>(readTotal);
+    ::close(targetFd);
+    return isWritten;
+}
+
+std::string frameName(size_t frameIndex)
+{
+    // Up to 20 digits of size_t and the terminator
+    char name[24];
+    std::snprintf(name, sizeof(name), "%04zu", frameIndex);
+    return name;
+}
+
+} // namespace
+
+SysfsRecorder::SysfsRecorder(const std::string &snapshotDir) :
+    m_snapshotDir {snapshotDir}
+{
+
+}
+
+std::vector<RecordedPath> SysfsRecorder::defaultPaths()
+{
+    std::vector<RecordedPath> paths {
+        {"/proc/stat", 0},
+        {"/proc/meminfo", 0},
+        {"/proc/cpuinfo", 0},
+        {"/proc/diskstats", 0},
+        {"/proc/net/dev", 0},
+        {"/proc/pressure", 0},
+        {"/proc/self/cgroup", 0},
+        {"/sys/class/hwmon", 1},
+        {"/sys/class/drm", 4},                  // cardN/device/hwmon/hwmonM/temp1_input
+        {"/sys/class/powercap", 1},
+        {"/sys/class/net", 2},                  // eth0/device/numa_node
+        {"/sys/bus/pci/devices", 1},
+        {"/sys/devices/system/cpu", 2},         // cpuN/cpufreq/scaling_cur_freq
+        {"/sys/devices/system/node", 1},
+        {"/sys/fs/cgroup", 0},
+    };
+
+    const auto selfCgroup = CgroupReader::selfCgroup();
+    if (!selfCgroup.empty() && selfCgroup != "/") {
+        paths.push_back({CgroupReader::defaultRoot() + selfCgroup, 0});
+    }
+    return paths;
+}
+
+size_t SysfsRecorder::record(size_t framesCount, std::chrono::milliseconds interval, const std::vector<RecordedPath> &paths)
+{
+    m_buffer.resize(MAX_FILE_SIZE);
+
+    size_t filesCount = 0;
+    for (size_t frameIndex = 0; frameIndex < framesCount; ++frameIndex)
+    {
+        if (frameIndex != 0) {
+            std::this_thread::sleep_for(interval);
+        }
+
+        const auto frameDir = m_snapshotDir + "/frames/" + frameName(frameIndex);
+        if (!makeDirectories(frameDir)) {
+            COMPLOG_WARNING("Error creating snapshot frame directory:", frameDir);
+            return 0;
+        }
+        filesCount = 0;
+        for (auto& recordedPath : paths) {
+            filesCount += recordPath(frameDir, recordedPath.path, recordedPath.depth);
+        }
+    }
+    return filesCount;
+}
+
+size_t SysfsRecorder::recordPath(const std::string &frameDir, const std::string &path, int depth)
+{
+    // stat() follows the links, so /sys/class entries land in the snapshot as plain directories
+    struct stat pathStat;
+    if (::stat(path.c_str(), &pathStat) != 0) {
+        return 0;
+    }
+
+    if (S_ISREG(pathStat.st_mode)) {
+        if ((pathStat.st_mode & 0444) == 0) {
+            return 0;
+        }
+        const auto separatorPos = path.rfind('/');
+        if (!makeDirectories(frameDir + path.substr(0, separatorPos))) {
+            return 0;
+        }
+        return copyFile(path, frameDir + path, m_buffer) ? 1 : 0;
+    }
+    if (!S_ISDIR(pathStat.st_mode)) {
+        return 0;
+    }
+
+    auto pDir = ::opendir(path.c_str());
+    if (pDir == nullptr) {
+        return 0;
+    }
+    std::vector<std::string> entryNames;
+    while (auto pEntry = ::readdir(pDir)) {
+        if (!isSkipped(pEntry->d_name)) {
+            entryNames.emplace_back(pEntry->d_name);
+        }
+    }
+    ::closedir(pDir);
+    makeDirectories(frameDir + path);
+
+    size_t filesCount = 0;
+    for (auto& entryName : entryNames)
+    {
+        const auto entryPath = path + "/" + entryName;
+        struct stat entryStat;
+        if (::stat(entryPath.c_str(), &entryStat) != 0) {
+            continue;
+        }
+        if (S_ISDIR(entryStat.st_mode)) {
+            if (depth > 0) {
+                filesCount += recordPath(frameDir, entryPath, depth - 1);
+            }
+        } else {
+            filesCount += recordPath(frameDir, entryPath, depth);
+        }
+    }
+    return filesCount;
+}
+
+SysfsReplayer::SysfsReplayer(const std::string &snapshotDir) :
+    m_liveDir {snapshotDir + "/live"}
+{
+    const auto framesRoot = snapshotDir + "/frames";
+    if (auto pDir = ::opendir(framesRoot.c_str()))
+    {
+        while (auto pEntry = ::readdir(pDir)) {
+            if (pEntry->d_name[0] != '.') {
+                m_frameDirs.push_back(framesRoot + "/" + pEntry->d_name);
+            }
+        }
+        ::closedir(pDir);
+    }
+    std::sort(m_frameDirs.begin(), m_frameDirs.end());
+
+    if (m_frameDirs.empty()) {
+        COMPLOG_WARNING("No recorded frames in snapshot:", snapshotDir);
+        return;
+    }
+    setFrame(0);
+}
+
+bool SysfsReplayer::isOpened() const noexcept
+{
+    return !m_frameDirs.empty();
+}
+
+size_t SysfsReplayer::framesCount() const noexcept
+{
+    return m_frameDirs.size();
+}
+
+size_t SysfsReplayer::currentFrame() const noexcept
+{
+    return m_currentFrame;
+}
+
+const std::string &SysfsReplayer::root() const noexcept
+{
+    return m_liveDir;
+}
+
+bool SysfsReplayer::setFrame(size_t frameIndex)
+{
+    if (frameIndex >= m_frameDirs.size()) {
+        return false;
+    }
+
+    // Depth-first over the frame; the recorder resolved every link, so only files and directories are here
+    std::vector<char> buffer(SysfsRecorder::MAX_FILE_SIZE);
+    std::vector<std::string> relativeDirs {""};
+    bool isCopied = true;
+    while (!relativeDirs.empty())
+    {
+        const auto relativeDir = std::move(relativeDirs.back());
+        relativeDirs.pop_back();
+
+        const auto frameDir = m_frameDirs[frameIndex] + relativeDir;
+        auto pDir = ::opendir(frameDir.c_str());
+        if (pDir == nullptr) {
+            isCopied = false;
+            continue;
+        }
+        makeDirectories(m_liveDir + relativeDir);
+        while (auto pEntry = ::readdir(pDir))
+        {
+            const std::string_view entryName = pEntry->d_name;
+            if (entryName == "." || entryName == "..") {
+                continue;
+            }
+            const auto relativePath = relativeDir + "/" + pEntry->d_name;
+            if (pEntry->d_type == DT_DIR) {
+                relativeDirs.push_back(relativePath);
+            } else if (!copyFile(m_frameDirs[frameIndex] + relativePath, m_liveDir + relativePath, buffer)) {
+                isCopied = false;
+            }
+        }
+        ::closedir(pDir);
+    }
+
+    m_currentFrame = frameIndex;
+    return isCopied;
+}
+
+bool SysfsReplayer::advance()
+{
+    if (m_frameDirs.empty()) {
+        return false;
+    }
+    return setFrame((m_currentFrame + 1) % m_frameDirs.size());
+}
+
+} // namespace SystemProcessing
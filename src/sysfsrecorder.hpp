@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+#include <chrono>
+#include <vector>
+
+namespace SystemProcessing {
+
+/**
+ * @brief The RecordedPath struct   Что записывать: файл или каталог и глубина обхода вложенных каталогов
+ */
+struct RecordedPath
+{
+    std::string path;   // Абсолютный путь на хосте ("/sys/class/hwmon")
+    int depth {0};      // 0 — только файлы самого каталога
+};
+
+/**
+ * @brief The SysfsRecorder class   Запись файлов /proc и /sys, которые читают коллекторы, в каталог снимка.
+ *                                  Каждый кадр — копия дерева в <snapshot>/frames/NNNN с теми же путями;
+ *                                  символические ссылки sysfs разворачиваются в обычные каталоги.
+ *                                  Несколько кадров через интервал дают меняющуюся последовательность для SysfsReplayer
+ */
+class SysfsRecorder
+{
+public:
+    static constexpr size_t MAX_FILE_SIZE = 1 << 20;
+
+    explicit SysfsRecorder(const std::string& snapshotDir);
+
+    /**
+     * @brief defaultPaths  Файлы, которые открывают читатели компонента: /proc/stat, meminfo, hwmon, drm, cpufreq,
+     *                      NUMA, powercap, корень cgroup. Каталоги процессов /proc/<pid> не записываются
+     */
+    static std::vector<RecordedPath> defaultPaths();
+
+    /**
+     * @brief record    Записать кадры 0..framesCount-1 с интервалом между ними
+     * @return  Число записанных файлов в последнем кадре, 0 — ошибка
+     */
+    size_t record(size_t framesCount = 1, std::chrono::milliseconds interval = std::chrono::seconds(1),
+                  const std::vector<RecordedPath>& paths = defaultPaths());
+
+private:
+    std::string m_snapshotDir;
+    std::vector<char> m_buffer;     // Содержимое копируемого файла, MAX_FILE_SIZE
+
+    size_t recordPath(const std::string& frameDir, const std::string& path, int depth);
+};
+
+/**
+ * @brief The SysfsReplayer class   Отдаёт записанный SysfsRecorder снимок как корень ФС (см. FsRoot).
+ *                                  Кадры копируются в <snapshot>/live перезаписью файлов на месте,
+ *                                  поэтому читатели с постоянно открытыми файлами видят новый кадр без переоткрытия
+ */
+class SysfsReplayer
+{
+public:
+    explicit SysfsReplayer(const std::string& snapshotDir);
+
+    bool isOpened() const noexcept;
+    size_t framesCount() const noexcept;
+    size_t currentFrame() const noexcept;
+
+    /**
+     * @brief root  Каталог, который передаётся в FsRoot::set
+     */
+    const std::string& root() const noexcept;
+
+    /**
+     * @brief setFrame  Переключить live на кадр. Файлы, которых нет в кадре, остаются от предыдущего
+     */
+    bool setFrame(size_t frameIndex);
+
+    /**
+     * @brief advance   Следующий кадр, после последнего — снова первый
+     */
+    bool advance();
+
+private:
+    std::string m_liveDir;
+    std::vector<std::string> m_frameDirs;
+    size_t m_currentFrame {0};
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,27 @@
+#include "sysutil.hpp"
+
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+std::string readSmallFile(const std::string& filePath)
+{
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
+    }
+    char buffer[256];
+    const auto readBytes = ::read(fd, buffer, sizeof(buffer));
+    ::close(fd);
+
+    std::string_view text(buffer, readBytes > 0 ? readBytes : 0);
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+        text.remove_suffix(1);
+    }
+    return std::string(text);
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include <time.h>
+
+namespace SystemProcessing {
+
+/**
+ * @brief monotonicNs   Время CLOCK_MONOTONIC в наносекундах — общая шкала проб и выборок читателей
+ */
+inline uint64_t monotonicNs() noexcept
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief readSmallFile Прочитать однострочный файл sysfs (до 256 байт) без завершающих пробелов и переводов строки
+ * @return  Пустая строка, если файл не открылся
+ */
+std::string readSmallFile(const std::string& filePath);
+
+} // namespace SystemProcessing
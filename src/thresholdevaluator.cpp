@@ -0,0 +1,145 @@
+#include "thresholdevaluator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+int ThresholdEvaluator::subscribe(const ThresholdRule &rule, ThresholdCallback callback)
+{
+    Subscription subscription;
+    subscription.rule = rule;
+    subscription.callback = std::make_shared<const ThresholdCallback>(std::move(callback));
+    return addSubscription(std::move(subscription));
+}
+
+int ThresholdEvaluator::subscribe(const ThresholdRule &rule, int eventFd)
+{
+    Subscription subscription;
+    subscription.rule = rule;
+    subscription.eventFd = eventFd;
+    return addSubscription(std::move(subscription));
+}
+
+bool ThresholdEvaluator::unsubscribe(int subscriptionId)
+{
+    std::unique_lock lock(m_mx);
+    auto subscriptionIt = m_subscriptions.find(subscriptionId);
+    if (subscriptionIt == m_subscriptions.end()) {
+        return false;
+    }
+    m_metricSubscriptions[static_cast<size_t>(subscriptionIt->second.rule.metric)]--;
+    m_subscriptions.erase(subscriptionIt);
+    lock.unlock();
+
+    // Wait out an evaluation that may already hold its event; from inside a handler the dispatch loop skips it instead
+    if (m_evaluatingThread.load(std::memory_order_acquire) != std::this_thread::get_id()) {
+        std::lock_guard evaluateLock(m_evaluateMx);
+    }
+    return true;
+}
+
+bool ThresholdEvaluator::isActive(int subscriptionId) const
+{
+    std::lock_guard lock(m_mx);
+    auto subscriptionIt = m_subscriptions.find(subscriptionId);
+    return subscriptionIt != m_subscriptions.end() && subscriptionIt->second.active;
+}
+
+bool ThresholdEvaluator::hasSubscriptions(StatusMetric metric) const
+{
+    std::lock_guard lock(m_mx);
+    return m_metricSubscriptions[static_cast<size_t>(metric)] != 0;
+}
+
+void ThresholdEvaluator::evaluate(StatusMetric metric, double value, uint64_t timestampNs)
+{
+    std::lock_guard evaluateLock(m_evaluateMx);
+    m_evaluatingThread.store(std::this_thread::get_id(), std::memory_order_release);
+    m_pendingEvents.clear();
+
+    {
+        std::lock_guard lock(m_mx);
+        for (auto& [id, subscription] : m_subscriptions) {
+            if (subscription.rule.metric != metric || !updateState(subscription, value)) {
+                continue;
+            }
+
+            PendingEvent pending;
+            pending.event.subscriptionId = id;
+            pending.event.metric = metric;
+            pending.event.value = value;
+            pending.event.active = subscription.active;
+            pending.event.timestampNs = timestampNs;
+            pending.callback = subscription.callback;
+            pending.eventFd = subscription.eventFd;
+            m_pendingEvents.push_back(std::move(pending));
+        }
+    }
+
+    for (auto& pending : m_pendingEvents) {
+        // A handler earlier in the batch may have unsubscribed this one
+        if (m_pendingEvents.size() > 1) {
+            std::lock_guard lock(m_mx);
+            if (m_subscriptions.count(pending.event.subscriptionId) == 0) {
+                continue;
+            }
+        }
+        if (pending.callback) {
+            (*pending.callback)(pending.event);
+        }
+        if (pending.eventFd >= 0) {
+            const uint64_t increment = 1;
+            [[maybe_unused]] auto written = ::write(pending.eventFd, &increment, sizeof(increment));
+        }
+    }
+    m_evaluatingThread.store(std::thread::id(), std::memory_order_release);
+}
+
+int ThresholdEvaluator::addSubscription(Subscription &&subscription)
+{
+    subscription.rule.samples = std::max<uint32_t>(1, subscription.rule.samples);
+
+    std::lock_guard lock(m_mx);
+    const int id = m_nextId++;
+    m_metricSubscriptions[static_cast<size_t>(subscription.rule.metric)]++;
+    m_subscriptions.emplace(id, std::move(subscription));
+    return id;
+}
+
+bool ThresholdEvaluator::updateState(Subscription &subscription, double value)
+{
+    const auto& rule = subscription.rule;
+
+    bool satisfied = false;
+    switch (rule.condition)
+    {
+    case ThresholdCondition::Above:
+        satisfied = subscription.active ? value > rule.threshold - rule.hysteresis : value > rule.threshold;
+        break;
+    case ThresholdCondition::Below:
+        satisfied = subscription.active ? value < rule.threshold + rule.hysteresis : value < rule.threshold;
+        break;
+    case ThresholdCondition::DeltaAbove:
+        satisfied = subscription.hasPrevious && std::fabs(value - subscription.previousValue) > rule.threshold;
+        subscription.previousValue = value;
+        subscription.hasPrevious = true;
+        break;
+    }
+
+    if (satisfied == subscription.active) {
+        subscription.streak = 0;
+        return false;
+    }
+
+    if (++subscription.streak < rule.samples) {
+        return false;
+    }
+    subscription.streak = 0;
+    subscription.active = satisfied;
+    return true;
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "statussnapshot.hpp"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SystemProcessing {
+
+enum class ThresholdCondition : uint8_t {
+    Above,      // value > threshold
+    Below,      // value < threshold
+    DeltaAbove  // |value - предыдущее значение| > threshold
+};
+
+/**
+ * @brief The ThresholdRule struct Условие срабатывания, например "температура > 85 три замера подряд"
+ */
+struct ThresholdRule
+{
+    StatusMetric metric {StatusMetric::CPULoad};
+    ThresholdCondition condition {ThresholdCondition::Above};
+    double threshold {0};
+    uint32_t samples {1};   // Сколько замеров подряд условие должно выполняться (и не выполняться для сброса)
+    double hysteresis {0};  // Для Above/Below: сброс только после отхода от порога на эту величину
+};
+
+/**
+ * @brief The ThresholdEvent struct    Переход условия в активное или неактивное состояние
+ */
+struct ThresholdEvent
+{
+    int subscriptionId {0};
+    StatusMetric metric {StatusMetric::CPULoad};
+    double value {0};
+    bool active {false};
+    uint64_t timestampNs {0};   // CLOCK_MONOTONIC
+};
+
+using ThresholdCallback = std::function<void(const ThresholdEvent& event)>;
+
+/**
+ * @brief The ThresholdEvaluator class Проверка подписок на пороги по каждому замеру.
+ *                                      Подписчики получают только переходы состояния
+ */
+class ThresholdEvaluator
+{
+public:
+    int subscribe(const ThresholdRule& rule, ThresholdCallback callback);
+
+    /**
+     * @brief subscribe Подписка через eventfd: на каждый переход в него пишется 1,
+     *                  текущее состояние берётся через isActive()
+     */
+    int subscribe(const ThresholdRule& rule, int eventFd);
+
+    /**
+     * @brief unsubscribe   Отменить подписку. Если evaluate() в другом потоке уже вызывает обработчики, ждёт его
+     *                      завершения: после возврата обработчик не вызывается и в eventfd ничего не пишется.
+     *                      Из обработчика можно отписываться без ожидания (и от других подписок тоже)
+     */
+    bool unsubscribe(int subscriptionId);
+    bool isActive(int subscriptionId) const;
+    bool hasSubscriptions(StatusMetric metric) const;
+
+    /**
+     * @brief evaluate  Проверить новое значение метрики. Обработчики вызываются в потоке вызова
+     */
+    void evaluate(StatusMetric metric, double value, uint64_t timestampNs);
+
+private:
+    struct Subscription
+    {
+        ThresholdRule rule;
+        std::shared_ptr<const ThresholdCallback> callback;
+        int eventFd {-1};
+
+        bool active {false};
+        uint32_t streak {0};    // Consecutive samples against the current state
+        bool hasPrevious {false};
+        double previousValue {0};
+    };
+
+    mutable std::mutex m_mx;
+    std::map<int, Subscription> m_subscriptions;
+    int m_nextId {1};
+    size_t m_metricSubscriptions[STATUS_METRICS_COUNT] {};
+
+    struct PendingEvent
+    {
+        ThresholdEvent event;
+        std::shared_ptr<const ThresholdCallback> callback;
+        int eventFd {-1};
+    };
+
+    // Reused between evaluate() calls, handlers are called after the lock is released
+    std::mutex m_evaluateMx;
+    std::atomic<std::thread::id> m_evaluatingThread {};
+    std::vector<PendingEvent> m_pendingEvents;
+
+    int addSubscription(Subscription&& subscription);
+    static bool updateState(Subscription& subscription, double value);
+};
+
+} // namespace SystemProcessing
@@ -0,0 +1,277 @@
+#include "tracerecorder.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace SystemProcessing {
+
+namespace
+{
+
+constexpr std::string_view TRACE_HEADER = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+constexpr std::string_view TRACE_FOOTER = "\n]}\n";
+
+void appendMicroseconds(std::string& oText, uint64_t valueNs)
+{
+    // Chrome trace timestamps are microseconds; the fraction keeps nanosecond spans visible
+    char buffer[32];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), valueNs / 1000);
+    *ptr++ = '.';
+    const auto fractionNs = valueNs % 1000;
+    *ptr++ = char('0' + fractionNs / 100);
+    *ptr++ = char('0' + fractionNs / 10 % 10);
+    *ptr++ = char('0' + fractionNs % 10);
+    oText.append(buffer, ptr);
+}
+
+void appendUnsigned(std::string& oText, uint64_t value)
+{
+    char buffer[24];
+    const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    oText.append(buffer, ptr);
+}
+
+void appendEscaped(std::string& oText, std::string_view value)
+{
+    // JSON string contents: quotes, backslashes and control characters are escaped
+    for (auto symbol : value) {
+        switch (symbol)
+        {
+        case '\\':  oText.append("\\\\"); break;
+        case '"':   oText.append("\\\""); break;
+        case '\n':  oText.append("\\n"); break;
+        case '\r':  oText.append("\\r"); break;
+        case '\t':  oText.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(symbol) < 0x20) {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(symbol));
+                oText.append(buffer);
+            } else {
+                oText.push_back(symbol);
+            }
+            break;
+        }
+    }
+}
+
+bool writeAll(int fd, std::string_view data) noexcept
+{
+    while (!data.empty()) {
+        const auto writtenBytes = ::write(fd, data.data(), data.size());
+        if (writtenBytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(writtenBytes);
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * Single producer (the owning thread) and single consumer (the flusher) ring
+ */
+struct TraceRecorder::ThreadBuffer
+{
+    uint32_t tid {0};
+    char threadName[16] {};
+    bool isNameWritten {false};     // Flusher only
+
+    alignas(64) std::atomic<uint64_t> head {0};
+    alignas(64) std::atomic<uint64_t> tail {0};
+    TraceEvent events[THREAD_BUFFER_EVENTS];
+};
+
+TraceRecorder &TraceRecorder::getInstance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+}
+
+bool TraceRecorder::start(const std::string &filePath, std::chrono::milliseconds flushInterval)
+{
+    std::lock_guard flushLock(m_flushMx);
+    if (m_fd >= 0) {
+        return false;
+    }
+    m_fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0 || !writeAll(m_fd, TRACE_HEADER)) {
+        COMPLOG_WARNING("Error opening trace file:", filePath, std::strerror(errno));
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        return false;
+    }
+    m_isFirstEvent = true;
+
+    {
+        std::lock_guard buffersLock(m_buffersMx);
+        for (auto& pBuffer : m_buffers) {
+            pBuffer->tail.store(pBuffer->head.load(std::memory_order_acquire), std::memory_order_release);
+            pBuffer->isNameWritten = false;
+        }
+    }
+
+    m_flushInterval = std::max(flushInterval, std::chrono::milliseconds(1));
+    m_stopRequested = false;
+    m_flusherThread = std::thread(&TraceRecorder::flusherLoop, this);
+    s_isEnabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    s_isEnabled.store(false, std::memory_order_relaxed);
+    if (m_flusherThread.joinable()) {
+        {
+            std::lock_guard lock(m_flusherMx);
+            m_stopRequested = true;
+        }
+        m_flusherCv.notify_all();
+        m_flusherThread.join();
+    }
+
+    flush();
+    std::lock_guard flushLock(m_flushMx);
+    if (m_fd >= 0) {
+        writeAll(m_fd, TRACE_FOOTER);
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void TraceRecorder::record(const char *name, uint64_t startNs, uint64_t durationNs) noexcept
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    auto& buffer = threadBuffer();
+    const auto head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= THREAD_BUFFER_EVENTS) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[head % THREAD_BUFFER_EVENTS] = {name, startNs, durationNs};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+uint64_t TraceRecorder::droppedEvents() const noexcept
+{
+    return m_droppedEvents.load(std::memory_order_relaxed);
+}
+
+TraceRecorder::ThreadBuffer &TraceRecorder::threadBuffer()
+{
+    // The recorder keeps its own reference, so events of an exited thread are still flushed
+    thread_local std::shared_ptr<ThreadBuffer> tl_pBuffer;
+    if (!tl_pBuffer) {
+        tl_pBuffer = std::make_shared<ThreadBuffer>();
+        tl_pBuffer->tid = static_cast<uint32_t>(::syscall(SYS_gettid));
+        ::pthread_getname_np(::pthread_self(), tl_pBuffer->threadName, sizeof(tl_pBuffer->threadName));
+
+        std::lock_guard lock(m_buffersMx);
+        m_buffers.push_back(tl_pBuffer);
+    }
+    return *tl_pBuffer;
+}
+
+void TraceRecorder::flusherLoop()
+{
+    std::unique_lock lock(m_flusherMx);
+    while (!m_stopRequested) {
+        m_flusherCv.wait_for(lock, m_flushInterval, [this]() { return m_stopRequested; });
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void TraceRecorder::flush()
+{
+    std::lock_guard flushLock(m_flushMx);
+    if (m_fd < 0) {
+        return;
+    }
+
+    const auto pid = static_cast<uint64_t>(::getpid());
+    auto appendSeparator = [this]() {
+        if (!m_isFirstEvent) {
+            m_text.append(",\n");
+        }
+        m_isFirstEvent = false;
+    };
+
+    m_text.clear();
+    std::unique_lock buffersLock(m_buffersMx);
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); )
+    {
+        auto& buffer = **it;
+        const auto head = buffer.head.load(std::memory_order_acquire);
+        auto tail = buffer.tail.load(std::memory_order_relaxed);
+
+        if (tail != head && !buffer.isNameWritten) {
+            appendSeparator();
+            m_text.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":");
+            appendUnsigned(m_text, pid);
+            m_text.append(",\"tid\":");
+            appendUnsigned(m_text, buffer.tid);
+            m_text.append(",\"args\":{\"name\":\"");
+            appendEscaped(m_text, buffer.threadName);
+            m_text.append("\"}}");
+            buffer.isNameWritten = true;
+        }
+        for (; tail != head; ++tail)
+        {
+            const auto& event = buffer.events[tail % THREAD_BUFFER_EVENTS];
+            appendSeparator();
+            m_text.append("{\"name\":\"");
+            appendEscaped(m_text, event.name);
+            m_text.append("\",\"cat\":\"SystemProcessing\",\"ph\":\"X\",\"ts\":");
+            appendMicroseconds(m_text, event.startNs);
+            m_text.append(",\"dur\":");
+            appendMicroseconds(m_text, event.durationNs);
+            m_text.append(",\"pid\":");
+            appendUnsigned(m_text, pid);
+            m_text.append(",\"tid\":");
+            appendUnsigned(m_text, buffer.tid);
+            m_text.push_back('}');
+        }
+        buffer.tail.store(tail, std::memory_order_release);
+
+        // Only the recorder holds the buffer of an exited thread, and it is drained now
+        if (it->use_count() == 1) {
+            it = m_buffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    buffersLock.unlock();
+
+    if (!m_text.empty() && !writeAll(m_fd, m_text)) {
+        COMPLOG_WARNING("Error writing trace file:", std::strerror(errno));
+    }
+}
+
+} // namespace SystemProcessing
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sysutil.hpp"
+
+// The same CMake option compiles the probes and the trace scopes out
+#ifndef SYSTEMPROCESSING_PROBES
+#define SYSTEMPROCESSING_PROBES 1
+#endif
+
+namespace SystemProcessing {
+
+/**
+ * @brief The TraceEvent struct    Завершённый интервал. name — строка со статическим временем жизни
+ */
+struct TraceEvent
+{
+    const char* name;
+    uint64_t startNs;       // CLOCK_MONOTONIC
+    uint64_t durationNs;
+};
+
+/**
+ * @brief The TraceRecorder class  Запись интервалов (проб, сканирований, запусков утилит) в файл Chrome trace JSON,
+ *                                 который открывают chrome://tracing и Perfetto UI.
+ *                                 У каждого потока свой кольцевой буфер без блокировок, файл пишет отдельный поток
+ *                                 раз в flushInterval. При переполнении буфера события теряются и считаются в droppedEvents
+ */
+class TraceRecorder
+{
+public:
+    static constexpr size_t THREAD_BUFFER_EVENTS = 8192;
+
+    static TraceRecorder& getInstance();
+
+    /**
+     * @brief start Начать запись в файл. События, накопленные до вызова, отбрасываются
+     * @return  false, если запись уже идёт или файл не открылся
+     */
+    bool start(const std::string& filePath, std::chrono::milliseconds flushInterval = std::chrono::milliseconds(200));
+
+    /**
+     * @brief stop  Дописать оставшиеся события и закрыть файл
+     */
+    void stop();
+
+    static bool isEnabled() noexcept { return s_isEnabled.load(std::memory_order_relaxed); }
+
+    void record(const char* name, uint64_t startNs, uint64_t durationNs) noexcept;
+
+    uint64_t droppedEvents() const noexcept;
+
+    static uint64_t nowNs() noexcept { return monotonicNs(); }
+
+private:
+    struct ThreadBuffer;
+
+    TraceRecorder() = default;
+    ~TraceRecorder();
+
+    ThreadBuffer& threadBuffer();
+    void flusherLoop();
+    void flush();
+
+    std::mutex m_buffersMx;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+
+    // Guarded by m_flushMx
+    std::mutex m_flushMx;
+    int m_fd {-1};
+    bool m_isFirstEvent {true};
+    std::string m_text;
+
+    std::thread m_flusherThread;
+    std::mutex m_flusherMx;
+    std::condition_variable m_flusherCv;
+    bool m_stopRequested {false};
+    std::chrono::milliseconds m_flushInterval {200};
+
+    std::atomic<uint64_t> m_droppedEvents {0};
+
+    static inline std::atomic<bool> s_isEnabled {false};
+};
+
+/**
+ * @brief The TraceScope class Интервал от создания до разрушения объекта. При выключенной записи стоит одну загрузку флага
+ */
+class TraceScope
+{
+public:
+#if SYSTEMPROCESSING_PROBES
+    explicit TraceScope(const char* name) noexcept :
+        m_name {TraceRecorder::isEnabled() ? name : nullptr}
+    {
+        if (m_name != nullptr) {
+            m_startNs = TraceRecorder::nowNs();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (m_name != nullptr) {
+            TraceRecorder::getInstance().record(m_name, m_startNs, TraceRecorder::nowNs() - m_startNs);
+        }
+    }
+
+private:
+    const char* m_name {nullptr};
+    uint64_t m_startNs {0};
+#else
+    explicit TraceScope(const char*) noexcept {}
+#endif // SYSTEMPROCESSING_PROBES
+
+public:
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+} // namespace SystemProcessing
+
+/**
+ * @brief SYSTEMPROCESSING_TRACE   Записать интервал traceName до конца блока. Для измеряемых проб
+ *                                 SYSTEMPROCESSING_PROBE пишет интервал сам
+ */
+#define SYSTEMPROCESSING_TRACE(scopeName, traceName) \
+    ::SystemProcessing::TraceScope scopeName(traceName)